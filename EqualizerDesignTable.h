@@ -0,0 +1,167 @@
+/* lookup table for the peak equalizer design of EqualizerDesign.h
+(audio EQ Cookbook by Robert Bristow-Johnson)
+
+The table is separable: the only expensive parts of the design are sin(w0), cos(w0)
+(depending on f0), A = 10^(gain/40) (depending on gain) and 1/(2Q). These are
+tabulated on a log-frequency, a log-Q and a gain axis and linearly interpolated, the
+remaining cookbook formulas are evaluated exactly (one division, no trigonometric functions).
+
+Error bound (linear interpolation of f on a grid with step h: |error| <= h^2/8 * max|f''|):
+    log-frequency axis (2048 nodes from minF0 up to fs/2, u = ln(f0), w0 = 2 pi e^u/fs):
+        |d^2/du^2 cos(w0)|, |d^2/du^2 sin(w0)| <= w0^2 + w0
+        -> |error of cos(w0), sin(w0)| <= h^2/8 * (w0^2 + w0) < 2.5e-5 for fs <= 192 kHz (minF0 = 50 Hz),
+           far below the band edges (w0 << 1) the error decreases with w0
+    log-Q axis (512 nodes, v = ln(Q), 1/(2Q) = e^-v/2):
+        relative error of 1/(2Q) <= h^2/8 = 1.0e-5 (Q from 0.1 to 10)
+    gain axis (512 nodes, A = e^(c*gain), c = ln(10)/40):
+        relative error of A <= h^2/8 * c^2 = 3.6e-6 (gain from -24 to 24 dB)
+The resulting magnitude response differs by less than 0.001 dB from the exact design for
+f0 <= 0.4 fs. Towards fs/2 sin(w0) gets small and its relative error grows, for deep cuts
+with high Q close to fs/2 the difference is up to 0.01 dB
+(see tester/designtable for the measurement over the full parameter range).
+
+Outside of the table range the exact design is used, so the error codes are the same
+as for designPeakEqualizer.
+
+version 1.0
+(c) J. Bitzer @ TGM, Jade Hochschule, BSD 3-Clause License
+*/
+
+#pragma once
+#include <vector>
+#include "EqualizerDesign.h"
+
+class PeakEqualizerDesignTable
+{
+public:
+    static constexpr int c_nrOfFreqNodes = 2048;
+    static constexpr int c_nrOfQNodes = 512;
+    static constexpr int c_nrOfGainNodes = 512;
+
+    /*
+        Builds the table for a given sampling rate (not realtime safe, call it in prepareToPlay).
+        @param fs The sampling frequency in Hz.
+        @param minF0 The lowest center frequency in the table (the highest is fs/2).
+        @param minQ, maxQ The range of the Q factor.
+        @param maxGain The gain range is -maxGain ... maxGain in dB.
+    */
+    void build(double fs, double minF0 = 50.0, double minQ = 0.1, double maxQ = 10.0, double maxGain = 24.0)
+    {
+        m_fs = fs;
+
+        m_minLogF0 = log(minF0);
+        m_maxLogF0 = log(0.5*fs);
+        double stepF0 = (m_maxLogF0 - m_minLogF0)/(c_nrOfFreqNodes - 1);
+        m_invStepF0 = 1.0/stepF0;
+        m_cosw0.resize(c_nrOfFreqNodes);
+        m_sinw0.resize(c_nrOfFreqNodes);
+        for (auto kk = 0; kk < c_nrOfFreqNodes; ++kk)
+        {
+            double w0 = 2.0 * M_PI * exp(m_minLogF0 + kk*stepF0) / fs;
+            m_cosw0[kk] = cos(w0);
+            m_sinw0[kk] = sin(w0);
+        }
+
+        m_minLogQ = log(minQ);
+        m_maxLogQ = log(maxQ);
+        double stepQ = (m_maxLogQ - m_minLogQ)/(c_nrOfQNodes - 1);
+        m_invStepQ = 1.0/stepQ;
+        m_invTwoQ.resize(c_nrOfQNodes);
+        for (auto kk = 0; kk < c_nrOfQNodes; ++kk)
+        {
+            m_invTwoQ[kk] = 0.5*exp(-(m_minLogQ + kk*stepQ));
+        }
+
+        m_minGain = -maxGain;
+        m_maxGain = maxGain;
+        double stepGain = (m_maxGain - m_minGain)/(c_nrOfGainNodes - 1);
+        m_invStepGain = 1.0/stepGain;
+        m_A.resize(c_nrOfGainNodes);
+        for (auto kk = 0; kk < c_nrOfGainNodes; ++kk)
+        {
+            m_A[kk] = pow(10.0, (m_minGain + kk*stepGain) / 40.0);
+        }
+        m_isBuilt = true;
+    }
+    bool isBuilt() const {return m_isBuilt;};
+    double getSamplingRate() const {return m_fs;};
+
+    /*
+        Same as designPeakEqualizer, but with logarithmic frequency and Q (as used by the parameters).
+        b and a are only resized if they do not have 3 elements.
+        @param b The return vector to store the numerator coefficients of the IIR filter.
+        @param a The return vector to store the denominator coefficients of the IIR filter.
+        @param logF0 The natural logarithm of the center frequency in Hz.
+        @param logQ The natural logarithm of the Q factor.
+        @param gain The desired gain in decibels (dB).
+
+        @return The error code (see designPeakEqualizer).
+    */
+    EqualizerErrorCode design(std::vector<double>& b, std::vector<double>& a, double logF0, double logQ, double gain) const
+    {
+        if (!m_isBuilt || logF0 < m_minLogF0 || logF0 > m_maxLogF0 || logQ < m_minLogQ || logQ > m_maxLogQ
+            || gain < m_minGain || gain > m_maxGain)
+        {
+            return designPeakEqualizer(b, a, exp(logF0), exp(logQ), gain, m_fs);
+        }
+
+        int index;
+        double frac;
+        getIndex((logF0 - m_minLogF0)*m_invStepF0, c_nrOfFreqNodes, index, frac);
+        double cosw0 = m_cosw0[index] + frac*(m_cosw0[index+1] - m_cosw0[index]);
+        double sinw0 = m_sinw0[index] + frac*(m_sinw0[index+1] - m_sinw0[index]);
+
+        getIndex((logQ - m_minLogQ)*m_invStepQ, c_nrOfQNodes, index, frac);
+        double invTwoQ = m_invTwoQ[index] + frac*(m_invTwoQ[index+1] - m_invTwoQ[index]);
+
+        getIndex((gain - m_minGain)*m_invStepGain, c_nrOfGainNodes, index, frac);
+        double A = m_A[index] + frac*(m_A[index+1] - m_A[index]);
+
+        double alpha = sinw0 * invTwoQ;
+        double invNorm = 1.0 / (1.0 + alpha / A);
+
+        if (b.size() != 3)
+            b.resize(3);
+        if (a.size() != 3)
+            a.resize(3);
+
+        b[0] = (1.0 + alpha * A)*invNorm;
+        b[1] = (-2.0 * cosw0)*invNorm;
+        b[2] = (1.0 - alpha * A)*invNorm;
+
+        a[0] = 1.0;
+        a[1] = b[1];
+        a[2] = (1.0 - alpha / A)*invNorm;
+
+        return NO_ERROR;
+    }
+
+private:
+    // position (already scaled to nodes) to index and fractional part, index+1 is always valid
+    static void getIndex(double position, int nrOfNodes, int& index, double& frac)
+    {
+        index = static_cast<int>(position);
+        if (index > nrOfNodes - 2)
+            index = nrOfNodes - 2;
+        frac = position - index;
+    }
+
+    bool m_isBuilt = false;
+    double m_fs = 44100.0;
+
+    double m_minLogF0 = 0.0;
+    double m_maxLogF0 = 0.0;
+    double m_invStepF0 = 1.0;
+    std::vector<double> m_cosw0;
+    std::vector<double> m_sinw0;
+
+    double m_minLogQ = 0.0;
+    double m_maxLogQ = 0.0;
+    double m_invStepQ = 1.0;
+    std::vector<double> m_invTwoQ;
+
+    double m_minGain = 0.0;
+    double m_maxGain = 0.0;
+    double m_invStepGain = 1.0;
+    std::vector<double> m_A;
+};
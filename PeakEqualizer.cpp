@@ -1,15 +1,17 @@
 #include <math.h>
+#include <thread>
 #include "PeakEqualizer.h"
 
 #include "EqualizerDesign.h"
-#include "hermite-cubic-curve.h"
 
-PeakEqualizerAudio::PeakEqualizerAudio()
-:SynchronBlockProcessor()
+template <typename FloatType>
+PeakEqualizerAudio<FloatType>::PeakEqualizerAudio()
+:SynchronBlockProcessor<FloatType>()
 {
 }
 
-void PeakEqualizerAudio::prepareToPlay(double sampleRate, int max_samplesPerBlock, int max_channels)
+template <typename FloatType>
+void PeakEqualizerAudio<FloatType>::prepareToPlay(double sampleRate, int max_samplesPerBlock, int max_channels)
 {
     juce::ignoreUnused(max_samplesPerBlock,max_channels);
     int synchronblocksize;
@@ -19,76 +21,214 @@ void PeakEqualizerAudio::prepareToPlay(double sampleRate, int max_samplesPerBloc
         int nextpowerof2 = int(log2(synchronblocksize))+1;
         synchronblocksize = int(pow(2,nextpowerof2));
     }
-    prepareSynchronProcessing(max_channels,synchronblocksize);
-    m_Latency += synchronblocksize;
+    this->prepareSynchronProcessing(max_channels,synchronblocksize,g_zeroLatency);
+    // the filters run at the oversampled rate, the parameters (smoothers) at the base rate
+    // (linear phase samples the designs at the base rate, without oversampling)
+    m_isLinearPhase = m_phaseParam.update() >= 0.5f;
+    int oversamplingFactor = m_isLinearPhase ? 1 : oversamplingChoiceToFactor(m_oversamplingParam.update());
+    m_oversampler.prepare(max_channels, synchronblocksize, oversamplingFactor);
+    m_Latency = this->getDelay() + m_oversampler.getLatency();
+    if (m_isLinearPhase)
+    {
+        // same frequency resolution at all sampling rates
+        int fftSize = g_linearPhaseFFTSize;
+        for (double fs = sampleRate; fs > 50000.0; fs *= 0.5)
+            fftSize *= 2;
+        m_linearPhase.prepare(max_channels, fftSize, g_nrOfBands);
+        m_Latency += m_linearPhase.getLatency();
+    }
     // here your code
-    m_fs = sampleRate;
-    m_f0 = 4000.f;
-    m_Q = 9.f;
-    m_gain = 20.f;
-    EqualizerErrorCode error = designPeakEqualizer(m_b, m_a, m_f0, m_Q, m_gain, m_fs);
-    if (error != NO_ERROR)
+    m_fs = static_cast<float>(sampleRate * m_oversampler.getFactor());
+    if (g_useSVFTopology)
+        m_svf.prepare(max_channels, g_nrOfBands);
+    else
+        m_filter.prepare(max_channels, g_nrOfBands);
+    m_b.resize(3);
+    m_a.resize(3);
+    // one task per channel group, the audio thread takes one share of the work itself
+    int nrOfWorkers = 0;
+    if (max_channels > g_parallelMinChannels)
     {
-        // handle error
-        m_b.resize(3);
-        m_a.resize(3);
-        m_b[0] = 1.0;
-        m_b[1] = 0.0;
-        m_b[2] = 0.0;
-        m_a[0] = 1.0;
-        m_a[1] = 0.0;
-        m_a[2] = 0.0;
+        int nrOfTasks = (max_channels + g_channelsPerTask - 1) / g_channelsPerTask;
+        int nrOfCores = static_cast<int>(std::thread::hardware_concurrency());
+        nrOfWorkers = juce::jmin(g_maxWorkerThreads, nrOfTasks - 1, juce::jmax(0, nrOfCores - 1));
     }
-    m_state_b1.resize(max_channels);
-    m_state_b2.resize(max_channels);
-    m_state_a1.resize(max_channels);
-    m_state_a2.resize(max_channels);
-    for (int i = 0; i < max_channels; i++)
+    if (nrOfWorkers == 0)
+        m_workerPool.reset();
+    else
     {
-        m_state_b1[i] = 0.f;
-        m_state_b2[i] = 0.f;
-        m_state_a1[i] = 0.f;
-        m_state_a2[i] = 0.f;
+        // the workers wake up once per synchron block
+        double callbackPeriod_s = synchronblocksize / sampleRate;
+        if (m_workerPool == nullptr || m_workerPool->getNrOfThreads() != nrOfWorkers || m_workerPool->getCallbackPeriod() != callbackPeriod_s)
+            m_workerPool = std::make_unique<jade::RealtimeWorkerPool>(nrOfWorkers, callbackPeriod_s);
     }
-    m_smoothingSamplerate = 1/(0.001*g_desired_blocksize_ms);
-    m_smoothedGain.reset(m_smoothingSamplerate, m_smoothingTime_s);
-    m_smoothedFreq.reset(m_smoothingSamplerate, m_smoothingTime_s);
-    m_smoothedQ.reset(m_smoothingSamplerate, m_smoothingTime_s);
-    m_smoothedGain.setCurrentAndTargetValue(m_gain);
-    m_smoothedFreq.setCurrentAndTargetValue(logf(m_f0));
-    m_smoothedQ.setCurrentAndTargetValue(logf(m_Q));
+    if (g_useDesignTable && !g_useMatchedDesign && (!g_useSVFTopology || m_isLinearPhase) && (!m_designTable.isBuilt() || m_designTable.getSamplingRate() != m_fs))
+        m_designTable.build(m_fs, exp(g_paramFreq.minValue), exp(g_paramQ.minValue), exp(g_paramQ.maxValue), g_paramGain.maxValue);
 
+    // the smoothers run at the audio rate and skip over each synchron block (blocks can be shorter in zero latency mode)
+    m_smoothingSamplerate = static_cast<float>(sampleRate);
+    for (auto band = 0; band < g_nrOfBands; ++band)
+    {
+        // start with the current parameter values, not with a ramp from the defaults
+        float gain = m_gainParam[band].update();
+        if (m_bypassParam[band].update() >= 0.5f)
+            gain = 0.f;
+        float logQ = m_QParam[band].update();
+        float logFreq = m_FreqParam[band].update();
+        m_smoothedGain[band].reset(m_smoothingSamplerate, m_smoothingTime_s);
+        m_smoothedFreq[band].reset(m_smoothingSamplerate, m_smoothingTime_s);
+        m_smoothedQ[band].reset(m_smoothingSamplerate, m_smoothingTime_s);
+        m_smoothedGain[band].setCurrentAndTargetValue(gain);
+        m_smoothedFreq[band].setCurrentAndTargetValue(logFreq);
+        m_smoothedQ[band].setCurrentAndTargetValue(logQ);
+
+        m_gain[band] = gain;
+        m_logQ[band] = logQ;
+        m_logF0[band] = logFreq;
+        // the bands start with their design (no fade in from flat after every prepare)
+        setBandActive(band, gain != 0.f);
+        designBand(band);
+    }
 }
 
-int PeakEqualizerAudio::processSynchronBlock(juce::AudioBuffer<float> & buffer, juce::MidiBuffer &midiMessages)
+template <typename FloatType>
+int PeakEqualizerAudio<FloatType>::processSynchronBlock(juce::AudioBuffer<FloatType> & buffer, juce::MidiBuffer &midiMessages)
 {
-    bool somethingchanged = false;
-    float gain;
-    somethingchanged = m_gainParam.updateWithNotification(gain);
-    if (somethingchanged)
-        m_smoothedGain.setTargetValue(gain);
-
-    m_gain = m_smoothedGain.getNextValue();
-    float Q;
-    somethingchanged = m_QParam.updateWithNotification(Q);
-    if (somethingchanged)
-        m_smoothedQ.setTargetValue(Q);
-
-    m_Q = exp(m_smoothedQ.getNextValue());
-
-    float freq;
-    somethingchanged |= m_FreqParam.updateWithNotification(freq);
-    if (somethingchanged)
-        m_smoothedFreq.setTargetValue(freq);
-    
-    m_f0 = exp(m_smoothedFreq.getNextValue());
+    int numSamples = buffer.getNumSamples();
+    for (auto band = 0; band < g_nrOfBands; ++band)
+    {
+        float value;
+        if (m_QParam[band].updateWithNotification(value))
+            m_smoothedQ[band].setTargetValue(value);
+        if (m_FreqParam[band].updateWithNotification(value))
+            m_smoothedFreq[band].setTargetValue(value);
+        // bypass fades the gain to 0 dB (an exact identity) instead of switching the band off hard
+        float gainValue, bypass;
+        bool gainChanged = m_gainParam[band].updateWithNotification(gainValue);
+        bool bypassChanged = m_bypassParam[band].updateWithNotification(bypass);
+        if (gainChanged || bypassChanged)
+            m_smoothedGain[band].setTargetValue(bypass < 0.5f ? gainValue : 0.f);
+
+        float gain = m_smoothedGain[band].skip(numSamples);
+        float logQ = m_smoothedQ[band].skip(numSamples);
+        float logF0 = m_smoothedFreq[band].skip(numSamples);
+
+        // a band at 0 dB is an identity and is skipped, it is switched on with identity states;
+        // when a fade reaches 0 dB the band ramps to the identity in this block and is switched off
+        // in the next one (its design is already the identity then, the cascade does not step)
+        bool wasActive = isBandActive(band);
+        if (gain == 0.f && (!wasActive || m_gain[band] == 0.f))
+        {
+            setBandActive(band, false);
+            continue;
+        }
+        setBandActive(band, true);
+
+        // redesign only bands whose parameters have changed
+        if (!wasActive || gain != m_gain[band] || logQ != m_logQ[band] || logF0 != m_logF0[band])
+        {
+            m_gain[band] = gain;
+            m_logQ[band] = logQ;
+            m_logF0[band] = logF0;
+            // a band that was just switched on ramps away from the identity
+            if (!wasActive && g_useSVFTopology)
+                m_svf.setIdentity(band);
+            else if (!wasActive)
+                m_filter.setIdentity(band);
+            designBand(band, g_interpolateCoefficients);
+        }
+    }
+
+    juce::ignoreUnused(midiMessages);
+    // all active bands are applied in one pass, coefficients are converted to float once per block
+    // (the ramps run over the oversampled block)
+    if (m_isLinearPhase)
+    {
+        // rebuffered to the frames of the WOLA, the equalizer has no midi output
+        m_linearPhase.processBlock(buffer, m_linearPhaseMidi);
+        m_linearPhaseMidi.clear();
+    }
+    else if (g_useSVFTopology)
+        processFilter(m_svf, buffer);
+    else
+        processFilter(m_filter, buffer);
+    return 0;
+}
+
+template <typename FloatType>
+template <typename Filter>
+void PeakEqualizerAudio<FloatType>::processFilter(Filter& filter, juce::AudioBuffer<FloatType>& buffer)
+{
+    int nrOfChannels = buffer.getNumChannels();
+    auto& oversampled = m_oversampler.prepareBlock(buffer);
+    if (m_workerPool == nullptr || nrOfChannels <= g_parallelMinChannels)
+    {
+        m_oversampler.upsampleChannels(buffer, 0, nrOfChannels);
+        filter.processBlock(oversampled);
+        m_oversampler.downsampleChannels(buffer, 0, nrOfChannels);
+        return;
+    }
+    // the ramps are shared by all channel groups, each task resamples and filters g_channelsPerTask channels
+    filter.prepareBlock(oversampled.getNumSamples());
+    auto task = [&](int index)
+    {
+        int startChannel = index * g_channelsPerTask;
+        int nrOfTaskChannels = juce::jmin(g_channelsPerTask, nrOfChannels - startChannel);
+        m_oversampler.upsampleChannels(buffer, startChannel, nrOfTaskChannels);
+        filter.processChannels(oversampled, startChannel, nrOfTaskChannels);
+        m_oversampler.downsampleChannels(buffer, startChannel, nrOfTaskChannels);
+    };
+    m_workerPool->run((nrOfChannels + g_channelsPerTask - 1) / g_channelsPerTask, task);
+    filter.finishBlock();
+}
+
+template <typename FloatType>
+bool PeakEqualizerAudio<FloatType>::isBandActive(int band) const
+{
+    if (m_isLinearPhase)
+        return m_linearPhase.isSectionActive(band);
+    return g_useSVFTopology ? m_svf.isSectionActive(band) : m_filter.isSectionActive(band);
+}
+
+template <typename FloatType>
+void PeakEqualizerAudio<FloatType>::setBandActive(int band, bool isActive)
+{
+    if (m_isLinearPhase)
+        m_linearPhase.setSectionActive(band, isActive);
+    else if (g_useSVFTopology)
+        m_svf.setSectionActive(band, isActive);
+    else
+        m_filter.setSectionActive(band, isActive);
+}
 
-    EqualizerErrorCode error = designPeakEqualizer(m_b, m_a, m_f0, m_Q, m_gain, m_fs);
-    if (error != NO_ERROR)
+template <typename FloatType>
+void PeakEqualizerAudio<FloatType>::designBand(int band, bool rampCoefficients)
+{
+    EqualizerErrorCode error;
+    // linear phase only needs the magnitude, it always uses the biquad designs
+    if (g_useSVFTopology && !m_isLinearPhase)
     {
+        double g, k, m1;
+        error = designPeakEqualizerSVF(g, k, m1, exp(m_logF0[band]), exp(m_logQ[band]), m_gain[band], m_fs);
         // handle error
-        m_b.resize(3);
-        m_a.resize(3);
+        if (error != NO_ERROR)
+            m_svf.setIdentity(band);
+        else if (rampCoefficients)
+            m_svf.setTargetCoefficients(band, g, k, m1);
+        else
+            m_svf.setCoefficients(band, g, k, m1);
+        return;
+    }
+    if (g_useMatchedDesign)
+        error = designPeakEqualizerMatched(m_b, m_a, exp(m_logF0[band]), exp(m_logQ[band]), m_gain[band], m_fs);
+    else if (g_useDesignTable)
+        error = m_designTable.design(m_b, m_a, m_logF0[band], m_logQ[band], m_gain[band]);
+    else
+        error = designPeakEqualizer(m_b, m_a, exp(m_logF0[band]), exp(m_logQ[band]), m_gain[band], m_fs);
+    // 0 dB (end of a fade out) is the exact identity, the section output equals its input at the end of the ramp
+    if (error != NO_ERROR || m_gain[band] == 0.f)
+    {
+        // handle error (m_b and m_a have 3 elements since prepareToPlay)
         m_b[0] = 1.0;
         m_b[1] = 0.0;
         m_b[2] = 0.0;
@@ -96,111 +236,151 @@ int PeakEqualizerAudio::processSynchronBlock(juce::AudioBuffer<float> & buffer,
         m_a[1] = 0.0;
         m_a[2] = 0.0;
     }
-
-    juce::ignoreUnused(midiMessages);
-    int numChannels = buffer.getNumChannels();
-    int numSamples = buffer.getNumSamples();
-    for (int channel = 0; channel < numChannels; channel++)
-    {
-        float* channelData = buffer.getWritePointer(channel);
-        for (int sample = 0; sample < numSamples; sample++)
-        {   
-            float In = channelData[sample];
-            float Out = m_b[0] * In + m_b[1] * m_state_b1[channel] + m_b[2] * m_state_b2[channel] 
-                    - m_a[1] * m_state_a1[channel] - m_a[2] * m_state_a2[channel];
-        
-            m_state_b2[channel] = m_state_b1[channel];
-            m_state_b1[channel] = In;
-            m_state_a2[channel] = m_state_a1[channel];
-            m_state_a1[channel] = Out;
-            channelData[sample] = Out;
-        }
-    }
-    return 0;
+    // the ramp runs sample by sample over the next synchron block
+    // (linear phase: the spectral gain changes from frame to frame, the overlap add smooths the steps)
+    if (m_isLinearPhase)
+        m_linearPhase.setCoefficients(band, m_b, m_a);
+    else if (rampCoefficients)
+        m_filter.setTargetCoefficients(band, m_b, m_a);
+    else
+        m_filter.setCoefficients(band, m_b, m_a);
 }
 
-void PeakEqualizerAudio::addParameter(std::vector<std::unique_ptr<juce::RangedAudioParameter>> &paramVector)
+template <typename FloatType>
+void PeakEqualizerAudio<FloatType>::addParameter(std::vector<std::unique_ptr<juce::RangedAudioParameter>> &paramVector)
 {
-    // this is just a placeholder (necessary for compiling/testing the template)
-    paramVector.push_back(std::make_unique<AudioParameterFloat>(g_paramGain.ID,
-        g_paramGain.name,
-        NormalisableRange<float>(g_paramGain.minValue, g_paramGain.maxValue),
-        g_paramGain.defaultValue,
-        AudioParameterFloatAttributes().withLabel (g_paramGain.unitName)
-                                        .withCategory (juce::AudioProcessorParameter::genericParameter)
-                                        // or two additional lines with lambdas to convert data for display
-                                        .withStringFromValueFunction (std::move ([](float value, int MaxLen) { value = int((value) * 10) * 0.1f;  return (String(value, MaxLen)); }))
-                                        .withValueFromStringFunction (std::move ([](const String& text) {return text.getFloatValue(); }))
-                        ));
-    // this is just a placeholder (necessary for compiling/testing the template)
-    paramVector.push_back(std::make_unique<AudioParameterFloat>(g_paramQ.ID,
-        g_paramQ.name,
-        NormalisableRange<float>(g_paramQ.minValue, g_paramQ.maxValue),
-        g_paramQ.defaultValue,
-        AudioParameterFloatAttributes().withLabel (g_paramQ.unitName)
-                                        .withCategory (juce::AudioProcessorParameter::genericParameter)
-                                        // or two additional lines with lambdas to convert data for display
-                                        .withStringFromValueFunction (std::move ([](float value, int MaxLen) { value = int(exp(value) * 100) * 0.01f;  return (String(value, MaxLen)); }))
-                                        .withValueFromStringFunction (std::move ([](const String& text) {return text.getFloatValue(); }))
+    for (auto band = 0; band < g_nrOfBands; ++band)
+    {
+        paramVector.push_back(std::make_unique<AudioParameterFloat>(getBandParameterID(g_paramGain.ID, band),
+            getBandParameterName(g_paramGain.name, band),
+            NormalisableRange<float>(g_paramGain.minValue, g_paramGain.maxValue),
+            g_paramGain.defaultValue,
+            AudioParameterFloatAttributes().withLabel (g_paramGain.unitName)
+                                            .withCategory (juce::AudioProcessorParameter::genericParameter)
+                                            // or two additional lines with lambdas to convert data for display
+                                            .withStringFromValueFunction (std::move ([](float value, int MaxLen) { value = int((value) * 10) * 0.1f;  return (String(value, MaxLen)); }))
+                                            .withValueFromStringFunction (std::move ([](const String& text) {return text.getFloatValue(); }))
+                            ));
+        paramVector.push_back(std::make_unique<AudioParameterFloat>(getBandParameterID(g_paramQ.ID, band),
+            getBandParameterName(g_paramQ.name, band),
+            NormalisableRange<float>(g_paramQ.minValue, g_paramQ.maxValue),
+            g_paramQ.defaultValue,
+            AudioParameterFloatAttributes().withLabel (g_paramQ.unitName)
+                                            .withCategory (juce::AudioProcessorParameter::genericParameter)
+                                            // or two additional lines with lambdas to convert data for display
+                                            .withStringFromValueFunction (std::move ([](float value, int MaxLen) { value = int(exp(value) * 100) * 0.01f;  return (String(value, MaxLen)); }))
+                                            .withValueFromStringFunction (std::move ([](const String& text) {return text.getFloatValue(); }))
+                            ));
+        paramVector.push_back(std::make_unique<AudioParameterFloat>(getBandParameterID(g_paramFreq.ID, band),
+            getBandParameterName(g_paramFreq.name, band),
+            NormalisableRange<float>(g_paramFreq.minValue, g_paramFreq.maxValue),
+            getBandDefaultFreq(band),
+            AudioParameterFloatAttributes().withLabel (g_paramFreq.unitName)
+                                            .withCategory (juce::AudioProcessorParameter::genericParameter)
+                                            // or two additional lines with lambdas to convert data for display
+                                            .withStringFromValueFunction (std::move ([](float value, int MaxLen) { value = int(exp(value) * 10) * 0.1f;  return (String(value, MaxLen)); }))
+                                            .withValueFromStringFunction (std::move ([](const String& text) {return text.getFloatValue(); }))
+                            ));
+        paramVector.push_back(std::make_unique<AudioParameterBool>(getBandParameterID(g_paramBypass.ID, band),
+            getBandParameterName(g_paramBypass.name, band),
+            g_paramBypass.defaultValue,
+            AudioParameterBoolAttributes().withLabel (g_paramBypass.unitName)
+                            ));
+    }
+    // not automatable, a change of the latency needs a new prepareToPlay (both)
+    paramVector.push_back(std::make_unique<AudioParameterChoice>(g_paramOversampling.ID,
+        g_paramOversampling.name,
+        g_paramOversampling.choices,
+        g_paramOversampling.defaultValue,
+        AudioParameterChoiceAttributes().withAutomatable(false)
                         ));
-    // this is just a placeholder (necessary for compiling/testing the template)
-    paramVector.push_back(std::make_unique<AudioParameterFloat>(g_paramFreq.ID,
-        g_paramFreq.name,
-        NormalisableRange<float>(g_paramFreq.minValue, g_paramFreq.maxValue),
-        g_paramFreq.defaultValue,
-        AudioParameterFloatAttributes().withLabel (g_paramFreq.unitName)
-                                        .withCategory (juce::AudioProcessorParameter::genericParameter)
-                                        // or two additional lines with lambdas to convert data for display
-                                        .withStringFromValueFunction (std::move ([](float value, int MaxLen) { value = int(exp(value) * 10) * 0.1f;  return (String(value, MaxLen)); }))
-                                        .withValueFromStringFunction (std::move ([](const String& text) {return text.getFloatValue(); }))
+    paramVector.push_back(std::make_unique<AudioParameterChoice>(g_paramPhase.ID,
+        g_paramPhase.name,
+        g_paramPhase.choices,
+        g_paramPhase.defaultValue,
+        AudioParameterChoiceAttributes().withAutomatable(false)
                         ));
-
 }
 
-void PeakEqualizerAudio::prepareParameter(std::unique_ptr<juce::AudioProcessorValueTreeState> &vts)
+template <typename FloatType>
+void PeakEqualizerAudio<FloatType>::prepareParameter(std::unique_ptr<juce::AudioProcessorValueTreeState> &vts)
 {
-    m_gainParam.prepareParameter(vts->getRawParameterValue(g_paramGain.ID));
-    m_QParam.prepareParameter(vts->getRawParameterValue(g_paramQ.ID));
-    // m_QParam.changeTransformer(jade::AudioProcessParameter<float>::transformerFunc::exptransform);
-    m_FreqParam.prepareParameter(vts->getRawParameterValue(g_paramFreq.ID));
-    // m_FreqParam.changeTransformer(jade::AudioProcessParameter<float>::transformerFunc::exptransform);
+    for (auto band = 0; band < g_nrOfBands; ++band)
+    {
+        m_gainParam[band].prepareParameter(vts->getRawParameterValue(getBandParameterID(g_paramGain.ID, band)));
+        m_QParam[band].prepareParameter(vts->getRawParameterValue(getBandParameterID(g_paramQ.ID, band)));
+        // m_QParam[band].changeTransformer(jade::AudioProcessParameter<float>::transformerFunc::exptransform);
+        m_FreqParam[band].prepareParameter(vts->getRawParameterValue(getBandParameterID(g_paramFreq.ID, band)));
+        // m_FreqParam[band].changeTransformer(jade::AudioProcessParameter<float>::transformerFunc::exptransform);
+        m_bypassParam[band].prepareParameter(vts->getRawParameterValue(getBandParameterID(g_paramBypass.ID, band)));
+    }
+    m_oversamplingParam.prepareParameter(vts->getRawParameterValue(g_paramOversampling.ID));
+    m_phaseParam.prepareParameter(vts->getRawParameterValue(g_paramPhase.ID));
 }
 
+template class PeakEqualizerAudio<float>;
+template class PeakEqualizerAudio<double>;
 
-PeakEqualizerGUI::PeakEqualizerGUI(juce::AudioProcessorValueTreeState& apvts)
+PeakEqualizerGUI::PeakEqualizerGUI(juce::AudioProcessorValueTreeState& apvts, SpectrumAnalyzer& analyzer)
 :m_apvts(apvts)
 {
+    for (auto band = 0; band < g_nrOfBands; ++band)
+        m_bandCombo.addItem("Band " + juce::String(band + 1), band + 1);
+    m_bandCombo.onChange = [this](){selectBand(m_bandCombo.getSelectedItemIndex());};
+    addAndMakeVisible(m_bandCombo);
+
+    m_bypassButton.setButtonText(g_paramBypass.name);
+    addAndMakeVisible(m_bypassButton);
+
+    m_oversamplingCombo.addItemList(g_paramOversampling.choices, 1);
+    m_oversamplingCombo.setTooltip(g_paramOversampling.name);
+    addAndMakeVisible(m_oversamplingCombo);
+    m_oversamplingAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(m_apvts, g_paramOversampling.ID, m_oversamplingCombo);
+
+    m_phaseCombo.addItemList(g_paramPhase.choices, 1);
+    m_phaseCombo.setTooltip(g_paramPhase.name);
+    addAndMakeVisible(m_phaseCombo);
+    m_phaseAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(m_apvts, g_paramPhase.ID, m_phaseCombo);
+
     m_GainSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryVerticalDrag);
     m_GainSlider.setTextBoxStyle(juce::Slider::TextBoxAbove, false, 70, 20);
     m_GainSlider.setRange(g_paramGain.minValue, g_paramGain.maxValue);
     m_GainSlider.setTextValueSuffix(g_paramGain.unitName);
-    auto val = m_apvts.getRawParameterValue(g_paramGain.ID);
-    m_GainSlider.setValue(*val);
-    m_GainSlider.onValueChange = [this](){m_drawer.setGain(m_GainSlider.getValue());};
-    m_gainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(m_apvts, g_paramGain.ID, m_GainSlider);
     addAndMakeVisible(m_GainSlider);
 
     m_QSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryVerticalDrag);
     m_QSlider.setTextBoxStyle(juce::Slider::TextBoxAbove, false, 70, 20);
     m_QSlider.setRange(g_paramQ.minValue, g_paramQ.maxValue);
     m_QSlider.setTextValueSuffix(g_paramQ.unitName);
-    val = m_apvts.getRawParameterValue(g_paramQ.ID);
-    m_QSlider.setValue(*val);
-    m_QSlider.onValueChange = [this](){m_drawer.setQ(m_QSlider.getValue());};
-    m_QAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(m_apvts, g_paramQ.ID, m_QSlider);
     addAndMakeVisible(m_QSlider);
 
     m_FreqSlider.setSliderStyle(juce::Slider::SliderStyle::RotaryVerticalDrag);
     m_FreqSlider.setTextBoxStyle(juce::Slider::TextBoxAbove, false, 70, 20);
     m_FreqSlider.setRange(g_paramFreq.minValue, g_paramFreq.maxValue);
     m_FreqSlider.setTextValueSuffix(g_paramFreq.unitName);
-    val = m_apvts.getRawParameterValue(g_paramFreq.ID);
-    m_FreqSlider.setValue(*val);
-    m_FreqSlider.onValueChange = [this](){m_drawer.setFreq(m_FreqSlider.getValue());};
-    m_FreqAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(m_apvts, g_paramFreq.ID, m_FreqSlider);
     addAndMakeVisible(m_FreqSlider);
 
+    m_drawer.setParameters(&m_apvts);
+    m_drawer.setAnalyzer(&analyzer);
     addAndMakeVisible(m_drawer);
+
+    m_bandCombo.setSelectedItemIndex(0, juce::dontSendNotification);
+    selectBand(0);
+}
+
+void PeakEqualizerGUI::selectBand(int band)
+{
+    m_selectedBand = band;
+    // the old attachments have to be removed before the sliders are attached to the parameters of the new band
+    m_gainAttachment.reset();
+    m_QAttachment.reset();
+    m_FreqAttachment.reset();
+    m_bypassAttachment.reset();
+    // attaching sets the slider values (the drawer polls the parameters of all bands)
+    m_gainAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(m_apvts, getBandParameterID(g_paramGain.ID, band), m_GainSlider);
+    m_QAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(m_apvts, getBandParameterID(g_paramQ.ID, band), m_QSlider);
+    m_FreqAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(m_apvts, getBandParameterID(g_paramFreq.ID, band), m_FreqSlider);
+    m_bypassAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(m_apvts, getBandParameterID(g_paramBypass.ID, band), m_bypassButton);
 }
 
 void PeakEqualizerGUI::paint(juce::Graphics &g)
@@ -224,52 +404,226 @@ void PeakEqualizerGUI::resized()
 
     // use the given canvas in r
     int height = r.getHeight();
-    m_GainSlider.setBounds(r.removeFromTop(height/4));
-    m_QSlider.setBounds(r.removeFromTop(height/4));
-    m_FreqSlider.setBounds(r.removeFromTop(height/4));
+    auto bandRow = r.removeFromTop(height/10);
+    m_bandCombo.setBounds(bandRow.removeFromLeft(bandRow.getWidth()/2));
+    m_bypassButton.setBounds(bandRow);
+    // settings of all bands
+    auto modeRow = r.removeFromTop(height/12);
+    m_oversamplingCombo.setBounds(modeRow.removeFromLeft(modeRow.getWidth()/2));
+    m_phaseCombo.setBounds(modeRow);
+    m_GainSlider.setBounds(r.removeFromTop(height/5));
+    m_QSlider.setBounds(r.removeFromTop(height/5));
+    m_FreqSlider.setBounds(r.removeFromTop(height/5));
     r.reduce(12,12);
     m_drawer.setBounds(r);
 
 }
 
-void PeakEqualizerTFDrawer::paint(juce::Graphics &g)
+PeakEqualizerTFDrawer::PeakEqualizerTFDrawer()
 {
-    g.setColour(juce::Colours::white);
-    g.fillAll();
+    // the grid covers the whole width: relFreq = 0.05 + 0.9*(logf - min)/(max - min) from 0 to 1
+    float logRange = g_paramFreq.maxValue - g_paramFreq.minValue;
+    m_response.prepare(g_responseNrOfPoints, exp(g_paramFreq.minValue - 0.05f/0.9f*logRange),
+        exp(g_paramFreq.maxValue + 0.05f/0.9f*logRange), g_nrOfBands);
+    m_b.resize(3);
+    m_a.resize(3);
+}
 
-    int height = getHeight();
-    int width = getWidth();
+PeakEqualizerTFDrawer::~PeakEqualizerTFDrawer()
+{
+    // no more samples from the audio thread
+    if (m_analyzer != nullptr)
+        m_analyzer->setActive(false);
+}
 
-    int starty = height/2;
-    int startx = 0;
-
-    int drawwidth = width;
-    int drawheight = height/2;
-
-    float relFreq = 0.05f + 0.9f*(m_Freq - g_paramFreq.minValue)/(g_paramFreq.maxValue - g_paramFreq.minValue);
-    float relQ = 0.99f - 0.98f*(m_Q - g_paramQ.minValue)/(g_paramQ.maxValue - g_paramQ.minValue);
-    HermiteCubicCurve <float> curve;
-    curve.add(0.f,0.f);
-    curve.add(relFreq-0.045, - relQ*m_Gain/g_paramGain.maxValue);
-    curve.add(relFreq, -m_Gain/g_paramGain.maxValue);
-    curve.add(relFreq+0.045, -relQ*m_Gain/g_paramGain.maxValue);
-    curve.add(1.f,0.f);
-    curve.finish();
-
-    float x0 = 0.f;
-    float y0 = curve.at(x0);
-    int NrOfEvalPoints = width;
-    g.setColour(juce::Colours::red);    
-    for (auto kk = 1; kk < NrOfEvalPoints; kk++)
+void PeakEqualizerTFDrawer::setParameters(juce::AudioProcessorValueTreeState* apvts)
+{
+    // the atomics live as long as the APVTS, no lookup by ID in the timer
+    for (auto band = 0; band < g_nrOfBands; ++band)
     {
-        float x1 = static_cast <float>(kk)/NrOfEvalPoints;
-        float y1 = curve.at(x1);
-        g.drawLine(startx + drawwidth*x0,starty + drawheight*y0,
-                    startx + drawwidth*x1, starty + drawheight*y1,2.0);
-        x0 = x1;
-        y0 = y1;
+        auto& parameters = m_bands[band];
+        parameters.logF0 = apvts->getRawParameterValue(getBandParameterID(g_paramFreq.ID, band));
+        parameters.logQ = apvts->getRawParameterValue(getBandParameterID(g_paramQ.ID, band));
+        parameters.gain = apvts->getRawParameterValue(getBandParameterID(g_paramGain.ID, band));
+        parameters.bypass = apvts->getRawParameterValue(getBandParameterID(g_paramBypass.ID, band));
+        parameters.isDesigned = false;
+    }
+    m_oversampling = apvts->getRawParameterValue(g_paramOversampling.ID);
+    m_phase = apvts->getRawParameterValue(g_paramPhase.ID);
+    updateResponse();
+    createCurvePath();
+    repaint();
+    startTimerHz(g_guiFrameRate);
+}
 
+void PeakEqualizerTFDrawer::setAnalyzer(SpectrumAnalyzer* analyzer)
+{
+    if (m_analyzer != nullptr)
+        m_analyzer->setActive(false);
+    m_analyzer = analyzer;
+    if (m_analyzer != nullptr)
+    {
+        m_analyzer->setActive(true);
+        startTimerHz(g_guiFrameRate);
     }
+    // the sampling rate of the curve comes from the analyzer
+    if (updateResponse())
+        createCurvePath();
+    createSpectrumPaths();
+    repaint();
+}
 
+void PeakEqualizerTFDrawer::resized()
+{
+    createCurvePath();
+    createSpectrumPaths();
+}
 
+void PeakEqualizerTFDrawer::timerCallback()
+{
+    // a hidden editor (e.g. another tab of the host) is not drawn, the analyzer skips the old samples later
+    if (!isShowing())
+        return;
+    // one repaint per tick at most, however many parameters changed in between
+    bool responseChanged = updateResponse();
+    if (responseChanged)
+        createCurvePath();
+    bool spectraChanged = m_analyzer != nullptr && m_analyzer->update();
+    if (spectraChanged)
+        createSpectrumPaths();
+    if (responseChanged || spectraChanged)
+        repaint();
+}
+
+bool PeakEqualizerTFDrawer::updateResponse()
+{
+    if (m_phase == nullptr)
+        return false;
+    // same sampling rate as the filters (no oversampling in the linear phase mode)
+    bool isLinearPhase = m_phase->load() > 0.5f;
+    int factor = isLinearPhase ? 1 : oversamplingChoiceToFactor(m_oversampling->load());
+    double fs = (m_analyzer != nullptr ? m_analyzer->getSampleRate() : 44100.0)*factor;
+    bool isNewSampleRate = fs != m_designedSampleRate;
+    m_designedSampleRate = fs;
+    m_response.setSampleRate(fs);
+
+    for (auto band = 0; band < g_nrOfBands; ++band)
+    {
+        auto& parameters = m_bands[band];
+        float logF0 = parameters.logF0->load();
+        float logQ = parameters.logQ->load();
+        float gain = parameters.gain->load();
+        m_response.setSectionActive(band, parameters.bypass->load() < 0.5f && gain != 0.f);
+        // only bands with new values are designed
+        if (parameters.isDesigned && !isNewSampleRate && logF0 == parameters.designedLogF0
+            && logQ == parameters.designedLogQ && gain == parameters.designedGain)
+            continue;
+        parameters.designedLogF0 = logF0;
+        parameters.designedLogQ = logQ;
+        parameters.designedGain = gain;
+        parameters.isDesigned = true;
+        // the design table approximates designPeakEqualizer, the SVF has the same response
+        EqualizerErrorCode error;
+        if (g_useMatchedDesign)
+            error = designPeakEqualizerMatched(m_b, m_a, exp(logF0), exp(logQ), gain, fs);
+        else
+            error = designPeakEqualizer(m_b, m_a, exp(logF0), exp(logQ), gain, fs);
+        if (error != NO_ERROR)
+        {
+            m_b = {1.0, 0.0, 0.0};
+            m_a = {1.0, 0.0, 0.0};
+        }
+        m_response.setCoefficients(band, m_b, m_a);
+    }
+    return m_response.update();
+}
+
+void PeakEqualizerTFDrawer::createCurvePath()
+{
+    // exact response of all bands, 0 dB in the middle, +-g_paramGain.maxValue at the borders
+    float width = static_cast<float>(getWidth());
+    float height = static_cast<float>(getHeight());
+    const auto& magnitude = m_response.getMagnitude_dB();
+    int nrOfPoints = m_response.getNrOfPoints();
+    m_curve.clear();
+    for (auto kk = 0; kk < nrOfPoints; ++kk)
+    {
+        float x = width*kk/(nrOfPoints - 1);
+        float y = 0.5f*height*(1.f - juce::jlimit(-1.f, 1.f, magnitude[kk]/g_paramGain.maxValue));
+        if (kk == 0)
+            m_curve.startNewSubPath(x, y);
+        else
+            m_curve.lineTo(x, y);
+    }
+    juce::PathStrokeType(2.0f).createStrokedPath(m_curveOutline, m_curve);
+}
+
+void PeakEqualizerTFDrawer::createSpectrumPaths()
+{
+    // spectra under the curve: output filled, input as line (0 dB full scale at the top)
+    m_outputSpectrum.clear();
+    m_inputSpectrum.clear();
+    m_inputOutline.clear();
+    int width = getWidth();
+    int height = getHeight();
+    if (m_analyzer == nullptr || width < 2)
+        return;
+    createSpectrumPath(m_outputSpectrum, m_analyzer->getLevels(SpectrumAnalyzer::Output), width, height);
+    m_outputSpectrum.lineTo(static_cast<float>(width - 1), static_cast<float>(height));
+    m_outputSpectrum.lineTo(0.f, static_cast<float>(height));
+    m_outputSpectrum.closeSubPath();
+    createSpectrumPath(m_inputSpectrum, m_analyzer->getLevels(SpectrumAnalyzer::Input), width, height);
+    juce::PathStrokeType(1.0f).createStrokedPath(m_inputOutline, m_inputSpectrum);
+}
+
+void PeakEqualizerTFDrawer::createSpectrumPath(juce::Path& path, const std::vector<float>& levels, int width, int height) const
+{
+    // inverse of the frequency axis of the curve: relFreq = 0.05 + 0.9*(logf - min)/(max - min)
+    float binsPerHz = static_cast<float>(m_analyzer->getFFTSize() / m_analyzer->getSampleRate());
+    int lastBin = static_cast<int>(levels.size()) - 1;
+    auto pixelToBin = [&](int x)
+    {
+        float logFreq = g_paramFreq.minValue + (static_cast<float>(x)/width - 0.05f)/0.9f*(g_paramFreq.maxValue - g_paramFreq.minValue);
+        return juce::jlimit(0.f, static_cast<float>(lastBin), expf(logFreq)*binsPerHz);
+    };
+
+    float bin0 = pixelToBin(0);
+    for (auto kk = 0; kk < width; ++kk)
+    {
+        float bin1 = pixelToBin(kk + 1);
+        float level;
+        if (static_cast<int>(bin1) > static_cast<int>(bin0) + 1)
+        {
+            // several bins in this column
+            level = levels[static_cast<int>(bin0)];
+            for (auto bin = static_cast<int>(bin0) + 1; bin <= static_cast<int>(bin1); ++bin)
+                level = juce::jmax(level, levels[bin]);
+        }
+        else
+        {
+            // less than one bin per column (low frequencies), linear interpolation
+            int bin = juce::jmin(static_cast<int>(bin0), lastBin - 1);
+            float frac = bin0 - bin;
+            level = levels[bin] + frac*(levels[bin + 1] - levels[bin]);
+        }
+        float y = height*level/g_analyzerMinLevel_dB;
+        if (kk == 0)
+            path.startNewSubPath(0.f, y);
+        else
+            path.lineTo(static_cast<float>(kk), y);
+        bin0 = bin1;
+    }
+}
+
+void PeakEqualizerTFDrawer::paint(juce::Graphics &g)
+{
+    // everything is prepared by the timer and resized
+    g.setColour(juce::Colours::white);
+    g.fillAll();
+    g.setColour(juce::Colours::lightblue);
+    g.fillPath(m_outputSpectrum);
+    g.setColour(juce::Colours::grey);
+    g.fillPath(m_inputOutline);
+    g.setColour(juce::Colours::red);
+    g.fillPath(m_curveOutline);
 }
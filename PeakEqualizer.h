@@ -1,9 +1,21 @@
 #pragma once
 
 #include <vector>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "tools/AudioProcessParameter.h"
+#include "tools/FrequencyResponse.h"
+#include "tools/LinearPhaseFilter.h"
 #include "tools/SynchronBlockProcessor.h"
+#include "tools/MultiChannelBiquad.h"
+#include "tools/MultiChannelSVF.h"
+#include "tools/PolyphaseOversampler.h"
+#include "tools/RealtimeWorkerPool.h"
+#include "tools/SpectrumAnalyzer.h"
+#include "EqualizerDesignTable.h"
 #include "PluginSettings.h"
 
 
@@ -35,14 +47,63 @@ const struct
 	const float maxValue = logf(15000.f);
 	const float defaultValue = logf(1000.f);
 }g_paramFreq;
+const struct
+{
+	const std::string ID = "BypassID";
+	const std::string name = "Bypass";
+	const std::string unitName = "";
+	const bool defaultValue = false;
+}g_paramBypass;
+// one parameter for all bands, changes the latency (the processor is prepared again)
+const struct
+{
+	const std::string ID = "OversamplingID";
+	const std::string name = "Oversampling";
+	const juce::StringArray choices = {"Off", "2x", "4x"};
+	const int defaultValue = 0;
+}g_paramOversampling;
+inline int oversamplingChoiceToFactor(float choice)
+{
+	return 1 << juce::jlimit(0, 2, static_cast<int>(choice + 0.5f));
+}
+// one parameter for all bands, linear phase has a latency of g_linearPhaseFFTSize (prepared again as well)
+const struct
+{
+	const std::string ID = "PhaseID";
+	const std::string name = "Phase";
+	const juce::StringArray choices = {"Minimum", "Linear"};
+	const int defaultValue = 0;
+}g_paramPhase;
+
+// band 0 uses the plain IDs from above (compatible with presets of the single band version),
+// all other bands get their band number appended
+inline std::string getBandParameterID(const std::string& ID, int band)
+{
+	if (band == 0)
+		return ID;
+	return ID + std::to_string(band + 1);
+}
+inline std::string getBandParameterName(const std::string& name, int band)
+{
+	return name + " " + std::to_string(band + 1);
+}
+// band 0 keeps the default of the single band version (sessions and automation rely on it),
+// the default center frequencies of the other bands are spread logarithmically over the frequency range
+inline float getBandDefaultFreq(int band)
+{
+	if (band == 0)
+		return g_paramFreq.defaultValue;
+	return g_paramFreq.minValue + (band - 0.5f)*(g_paramFreq.maxValue - g_paramFreq.minValue)/(g_nrOfBands - 1);
+}
 
 
-class PeakEqualizerAudio : public SynchronBlockProcessor
+template <typename FloatType>
+class PeakEqualizerAudio : public SynchronBlockProcessor<FloatType>
 {
 public:
     PeakEqualizerAudio();
     void prepareToPlay(double sampleRate, int max_samplesPerBlock, int max_channels);
-    virtual int processSynchronBlock(juce::AudioBuffer<float>&, juce::MidiBuffer& midiMessages);
+    virtual int processSynchronBlock(juce::AudioBuffer<FloatType>&, juce::MidiBuffer& midiMessages);
 
     // parameter handling
   	void addParameter(std::vector < std::unique_ptr<juce::RangedAudioParameter>>& paramVector);
@@ -50,47 +111,107 @@ public:
     
     // some necessary info for the host
     int getLatency(){return m_Latency;};
+    int getOversamplingFactor() const {return m_oversampler.getFactor();};
+    bool isLinearPhase() const {return m_isLinearPhase;};
 
 private:
+    void designBand(int band, bool rampCoefficients = false);
+    // the filter of the current mode (biquads, SVF or linear phase)
+    bool isBandActive(int band) const;
+    void setBandActive(int band, bool isActive);
+    // oversamples and filters all channels, in channel groups on the worker pool for large busses
+    template <typename Filter>
+    void processFilter(Filter& filter, juce::AudioBuffer<FloatType>& buffer);
+
     int m_Latency = 0;
 	float m_fs = 44100.f;
-	float m_f0 = 1000.f;
-	float m_Q = 1.f;
-	float m_gain = 0.f;
+	// design values of every band (the coefficients in m_filter / m_svf belong to these),
+	// frequency and Q are logarithmic as the parameters
+	std::array<float, g_nrOfBands> m_logF0;
+	std::array<float, g_nrOfBands> m_logQ;
+	std::array<float, g_nrOfBands> m_gain;
 	std::vector<double> m_b;
 	std::vector<double> m_a;
-	std::vector<float> m_state_b1;
-	std::vector<float> m_state_b2;
-	std::vector<float> m_state_a1;
-	std::vector<float> m_state_a2;
-
-	jade::AudioProcessParameter<float> m_gainParam;
-	jade::AudioProcessParameter<float> m_QParam;
-	jade::AudioProcessParameter<float> m_FreqParam;
-
-	juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> m_smoothedGain;
-	juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> m_smoothedFreq;
-	juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear> m_smoothedQ;
+	PeakEqualizerDesignTable m_designTable;
+	// only one of both is used (g_useSVFTopology)
+	MultiChannelBiquad<FloatType> m_filter;
+	MultiChannelSVF<FloatType> m_svf;
+	// only created in prepareToPlay for more than g_parallelMinChannels channels
+	std::unique_ptr<jade::RealtimeWorkerPool> m_workerPool;
+	// around the filters, the factor is set in prepareToPlay (RBJ designs cramp near fs/2)
+	PolyphaseOversampler<FloatType> m_oversampler;
+	jade::AudioProcessParameter<float> m_oversamplingParam;
+	// replaces m_filter / m_svf if m_isLinearPhase (set in prepareToPlay), gets the biquad designs of all bands
+	LinearPhaseFilter<FloatType> m_linearPhase;
+	jade::AudioProcessParameter<float> m_phaseParam;
+	bool m_isLinearPhase = false;
+	juce::MidiBuffer m_linearPhaseMidi;
+
+	// one parameter of each kind per band
+	std::array<jade::AudioProcessParameter<float>, g_nrOfBands> m_gainParam;
+	std::array<jade::AudioProcessParameter<float>, g_nrOfBands> m_QParam;
+	std::array<jade::AudioProcessParameter<float>, g_nrOfBands> m_FreqParam;
+	std::array<jade::AudioProcessParameter<float>, g_nrOfBands> m_bypassParam;
+
+	std::array<juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear>, g_nrOfBands> m_smoothedGain;
+	std::array<juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear>, g_nrOfBands> m_smoothedFreq;
+	std::array<juce::SmoothedValue<float, juce::ValueSmoothingTypes::Linear>, g_nrOfBands> m_smoothedQ;
 	float m_smoothingTime_s = 0.05f;
 	float m_smoothingSamplerate; 
 
 };
 
-class PeakEqualizerTFDrawer : public juce::Component
+// All drawing data (curve and spectra) are cached paths, paint only fills them.
+// The parameters and the analyzer are polled by a timer with g_guiFrameRate (covers sliders and automation),
+// the paths are rebuilt and repainted only if something changed, or in resized.
+class PeakEqualizerTFDrawer : public juce::Component, private juce::Timer
 {
 public:
-	PeakEqualizerTFDrawer(){};
+	PeakEqualizerTFDrawer();
+	~PeakEqualizerTFDrawer();
 	void paint(juce::Graphics& g) override;
-	void resized() {};
-	void setQ(float Q){m_Q = Q; repaint();};
-	void setFreq(float Freq) {m_Freq = Freq; repaint();};
-	void setGain(float Gain) {m_Gain = Gain; repaint();};
+	void resized() override;
+	// the curve is the response of all bands, designed from the raw parameter values
+	void setParameters(juce::AudioProcessorValueTreeState* apvts);
+	// the spectra are drawn under the curve, the analyzer is active as long as the drawer exists
+	void setAnalyzer(SpectrumAnalyzer* analyzer);
 
 private:
-	float m_Gain = 0.f;
-	float m_Q = logf(1.f);
-	float m_Freq = logf(1000.f);
-
+	void timerCallback() override;
+	// designs the changed bands as the audio thread does, returns true if the response changed
+	bool updateResponse();
+	void createCurvePath();
+	void createSpectrumPaths();
+	// one point per pixel column (the highest level of its bins), same frequency axis as the curve
+	void createSpectrumPath(juce::Path& path, const std::vector<float>& levels, int width, int height) const;
+
+	// raw parameter values of all bands and the last designed ones
+	struct BandParameters
+	{
+		std::atomic<float>* logF0 = nullptr;
+		std::atomic<float>* logQ = nullptr;
+		std::atomic<float>* gain = nullptr;
+		std::atomic<float>* bypass = nullptr;
+		float designedLogF0 = 0.f;
+		float designedLogQ = 0.f;
+		float designedGain = 0.f;
+		bool isDesigned = false;
+	};
+	std::array<BandParameters, g_nrOfBands> m_bands;
+	std::atomic<float>* m_oversampling = nullptr;
+	std::atomic<float>* m_phase = nullptr;
+	double m_designedSampleRate = 0.0;
+	FrequencyResponse m_response;
+	std::vector<double> m_b;
+	std::vector<double> m_a;
+	SpectrumAnalyzer* m_analyzer = nullptr;
+
+	// cached outlines (strokes as filled paths)
+	juce::Path m_curve;
+	juce::Path m_curveOutline;
+	juce::Path m_outputSpectrum;
+	juce::Path m_inputSpectrum;
+	juce::Path m_inputOutline;
 };
 
 
@@ -98,12 +219,22 @@ private:
 class PeakEqualizerGUI : public juce::Component
 {
 public:
-	PeakEqualizerGUI(juce::AudioProcessorValueTreeState& apvts);
+	PeakEqualizerGUI(juce::AudioProcessorValueTreeState& apvts, SpectrumAnalyzer& analyzer);
 
 	void paint(juce::Graphics& g) override;
 	void resized() override;
 private:
+	void selectBand(int band);
+
     juce::AudioProcessorValueTreeState& m_apvts;
+	int m_selectedBand = 0;
+	juce::ComboBox m_bandCombo;
+	juce::ToggleButton m_bypassButton;
+	juce::ComboBox m_oversamplingCombo;
+	std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> m_oversamplingAttachment;
+	juce::ComboBox m_phaseCombo;
+	std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> m_phaseAttachment;
+	std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> m_bypassAttachment;
 	juce::Slider m_GainSlider;
 	juce::Slider m_QSlider;
 	juce::Slider m_FreqSlider;
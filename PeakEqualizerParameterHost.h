@@ -0,0 +1,88 @@
+/* parameter host for PeakEqualizerAudio without plugin wrapper (benchmark, batch renderer)
+
+Owns the parameters and the AudioProcessorValueTreeState exactly as PeakEqualizerAudioProcessor
+(same IDs and state type, therefore presets of the plugin can be loaded), but has no editor,
+no preset handler and no processing. Any number of PeakEqualizerAudio instances (on any thread)
+can read the parameters after prepareParameter(host.getVTS()).
+
+version 1.0
+(c) J. Bitzer @ TGM, Jade Hochschule, BSD 3-Clause License
+*/
+
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "PeakEqualizer.h"
+
+class PeakEqualizerParameterHost : public juce::AudioProcessor
+{
+public:
+    PeakEqualizerParameterHost()
+    {
+        m_algo.addParameter(m_paramVector);
+        m_parameterVTS = std::make_unique<juce::AudioProcessorValueTreeState>(*this, nullptr, juce::Identifier("PeakEqualizerVTS"),
+            juce::AudioProcessorValueTreeState::ParameterLayout(m_paramVector.begin(), m_paramVector.end()));
+    }
+    std::unique_ptr<juce::AudioProcessorValueTreeState>& getVTS() {return m_parameterVTS;};
+
+    /*
+        Sets a parameter in its own unit (Freq and Q are logarithmic, see g_paramFreq and g_paramQ).
+        @return false if there is no parameter with this ID.
+    */
+    bool setParameter(const std::string& ID, float value)
+    {
+        auto parameter = m_parameterVTS->getParameter(ID);
+        if (parameter == nullptr)
+            return false;
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+        return true;
+    }
+    // sets one band (0 ... g_nrOfBands-1) with frequency in Hz and linear Q
+    bool setBand(int band, float gain, float freq, float Q, bool bypass = false)
+    {
+        if (band < 0 || band >= g_nrOfBands || freq <= 0.f || Q <= 0.f)
+            return false;
+        setParameter(getBandParameterID(g_paramGain.ID, band), gain);
+        setParameter(getBandParameterID(g_paramFreq.ID, band), logf(freq));
+        setParameter(getBandParameterID(g_paramQ.ID, band), logf(Q));
+        setParameter(getBandParameterID(g_paramBypass.ID, band), bypass ? 1.f : 0.f);
+        return true;
+    }
+    /*
+        Loads a preset file as written by PresetHandler.
+        @return false if the file can not be parsed or is not a preset of this plugin.
+    */
+    bool loadPreset(const juce::File& presetFile)
+    {
+        std::unique_ptr<juce::XmlElement> xml(juce::XmlDocument::parse(presetFile));
+        if (xml == nullptr || !xml->hasTagName(m_parameterVTS->state.getType()))
+            return false;
+        m_parameterVTS->replaceState(juce::ValueTree::fromXml(*xml));
+        return true;
+    }
+
+    const juce::String getName() const override {return "PeakEqualizerParameterHost";};
+    void prepareToPlay(double, int) override {};
+    void releaseResources() override {};
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override {};
+    double getTailLengthSeconds() const override {return 0.0;};
+    bool acceptsMidi() const override {return false;};
+    bool producesMidi() const override {return false;};
+    juce::AudioProcessorEditor* createEditor() override {return nullptr;};
+    bool hasEditor() const override {return false;};
+    int getNumPrograms() override {return 1;};
+    int getCurrentProgram() override {return 0;};
+    void setCurrentProgram(int) override {};
+    const juce::String getProgramName(int) override {return {};};
+    void changeProgramName(int, const juce::String&) override {};
+    void getStateInformation(juce::MemoryBlock&) override {};
+    void setStateInformation(const void*, int) override {};
+
+private:
+    // only used for addParameter
+    PeakEqualizerAudio<float> m_algo;
+    std::unique_ptr<juce::AudioProcessorValueTreeState> m_parameterVTS;
+    std::vector<std::unique_ptr<juce::RangedAudioParameter>> m_paramVector;
+};
@@ -1,5 +1,6 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "tools/RealtimeSafetyChecker.h"
 
 //==============================================================================
 PeakEqualizerAudioProcessor::PeakEqualizerAudioProcessor()
@@ -19,6 +20,7 @@ PeakEqualizerAudioProcessor::PeakEqualizerAudioProcessor()
         AudioProcessorValueTreeState::ParameterLayout(m_paramVector.begin(), m_paramVector.end()));
 
     m_algo.prepareParameter(m_parameterVTS);
+    m_algoDouble.prepareParameter(m_parameterVTS);
 
 	m_presets.setAudioValueTreeState(m_parameterVTS.get());
     // if needed add categories, if g_PresetCategories contains one empty string "", nothing happened
@@ -28,14 +30,19 @@ PeakEqualizerAudioProcessor::PeakEqualizerAudioProcessor()
     m_presets.DeployFactoryPresets();
 #endif
     
-	m_presets.loadfromFileAllUserPresets();    
+    // parsed in the background, a large preset library does not stall the project load
+	m_presets.startLoadingAllUserPresets();
 
     setLatencySamples(m_algo.getLatency());
+    m_parameterVTS->addParameterListener(g_paramOversampling.ID, this);
+    m_parameterVTS->addParameterListener(g_paramPhase.ID, this);
 }
 
 PeakEqualizerAudioProcessor::~PeakEqualizerAudioProcessor()
 {
-
+    m_parameterVTS->removeParameterListener(g_paramOversampling.ID, this);
+    m_parameterVTS->removeParameterListener(g_paramPhase.ID, this);
+    cancelPendingUpdate();
 }
 
 //==============================================================================
@@ -118,7 +125,30 @@ void PeakEqualizerAudioProcessor::prepareToPlay (double sampleRate, int samplesP
 
     juce::ignoreUnused (samplesPerBlock);
     m_fs = static_cast<float>(sampleRate);
-    m_algo.prepareToPlay(sampleRate,samplesPerBlock,nrofchannels);
+    if (isUsingDoublePrecision())
+        m_algoDouble.prepareToPlay(sampleRate,samplesPerBlock,nrofchannels);
+    else
+        m_algo.prepareToPlay(sampleRate,samplesPerBlock,nrofchannels);
+    m_analyzer.prepare(sampleRate);
+    // the latency depends on the block size (and is 0 in zero latency mode)
+    setLatencySamples(isUsingDoublePrecision() ? m_algoDouble.getLatency() : m_algo.getLatency());
+}
+
+void PeakEqualizerAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue)
+{
+    juce::ignoreUnused(parameterID, newValue);
+    triggerAsyncUpdate();
+}
+
+void PeakEqualizerAudioProcessor::handleAsyncUpdate()
+{
+    // not prepared yet, prepareToPlay reads the parameter
+    if (getSampleRate() <= 0.0)
+        return;
+    // waits for the current processBlock call, the host gets the new latency in prepareToPlay
+    suspendProcessing(true);
+    prepareToPlay(getSampleRate(), getBlockSize());
+    suspendProcessing(false);
 }
 
 void PeakEqualizerAudioProcessor::releaseResources()
@@ -134,9 +164,10 @@ bool PeakEqualizerAudioProcessor::isBusesLayoutSupported (const BusesLayout& lay
     return true;
   #else
     // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Every channel is filtered the same way, therefore any layout (mono, stereo, surround,
+    // ambisonics, discrete) up to g_maxChannels channels is fine.
+    auto outputSet = layouts.getMainOutputChannelSet();
+    if (outputSet.isDisabled() || outputSet.size() > g_maxChannels)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -152,6 +183,20 @@ bool PeakEqualizerAudioProcessor::isBusesLayoutSupported (const BusesLayout& lay
 void PeakEqualizerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer,
                                               juce::MidiBuffer& midiMessages)
 {
+    processBlockInternal(buffer, midiMessages, m_algo);
+}
+
+void PeakEqualizerAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer,
+                                              juce::MidiBuffer& midiMessages)
+{
+    processBlockInternal(buffer, midiMessages, m_algoDouble);
+}
+
+template <typename FloatType>
+void PeakEqualizerAudioProcessor::processBlockInternal (juce::AudioBuffer<FloatType>& buffer,
+                                              juce::MidiBuffer& midiMessages, PeakEqualizerAudio<FloatType>& algo)
+{
+    JADE_REALTIME_SCOPE;
  #if WITH_MIDIKEYBOARD  
 	m_keyboardState.processNextMidiBuffer(midiMessages, 0, buffer.getNumSamples(), true);
     m_wheelState.processNextMidiBuffer(midiMessages,true);
@@ -179,7 +224,9 @@ void PeakEqualizerAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer
     // Alternatively, you can process the samples with the channels
     // interleaved by keeping the same state.
 
-    m_algo.processBlock(buffer,midiMessages);
+    m_analyzer.pushSamples(SpectrumAnalyzer::Input, buffer);
+    algo.processBlock(buffer,midiMessages);
+    m_analyzer.pushSamples(SpectrumAnalyzer::Output, buffer);
 
 #if WITH_MIDIKEYBOARD  
     midiMessages.clear(); // except you want to create new midi messages, but than say so 
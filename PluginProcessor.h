@@ -6,7 +6,9 @@
 #include "PeakEqualizer.h"
 
 //==============================================================================
-class PeakEqualizerAudioProcessor  : public juce::AudioProcessor
+class PeakEqualizerAudioProcessor  : public juce::AudioProcessor,
+                                     private juce::AudioProcessorValueTreeState::Listener,
+                                     private juce::AsyncUpdater
 {
 public:
     friend class PeakEqualizerAudioProcessorEditor;
@@ -21,7 +23,8 @@ public:
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
-    using AudioProcessor::processBlock;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override {return true;};
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -50,6 +53,13 @@ public:
     void setScaleFactor(float newscalefactor){m_pluginScaleFactor = newscalefactor;};
 
 private:
+    // oversampling and phase mode change the latency, the processing is prepared again on the message thread
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
+
+    template <typename FloatType>
+    void processBlockInternal (juce::AudioBuffer<FloatType>&, juce::MidiBuffer&, PeakEqualizerAudio<FloatType>& algo);
+
     CriticalSection m_protect;
     float m_fs; // sampling rate is always needed
 
@@ -64,7 +74,11 @@ private:
 #endif
     // Your plugin stuff
 
-    PeakEqualizerAudio m_algo;
+    // the host decides before prepareToPlay which precision is used, only this one is prepared
+    PeakEqualizerAudio<float> m_algo;
+    PeakEqualizerAudio<double> m_algoDouble;
+    // input and output spectra for the editor (only fed while the editor is open)
+    SpectrumAnalyzer m_analyzer;
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PeakEqualizerAudioProcessor)
 };
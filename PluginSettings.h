@@ -1,8 +1,19 @@
 #pragma once
 #include "Versioning.h" // this file is generated by CMAKE during build process
 // ------------Audio -----------------
-const int g_desired_blocksize_ms(1); // its in ms to be independent from the sampling rate
+const int g_desired_blocksize_ms(1); // its in ms to be independent from the sampling rate (with g_interpolateCoefficients 4-8 ms are fine)
+const bool g_interpolateCoefficients(true); // ramp the filter coefficients sample by sample over each synchron block
+const bool g_useDesignTable(true); // design by interpolated lookup table instead of sin/cos/pow (see EqualizerDesignTable.h)
+const bool g_useMatchedDesign(false); // matched (Vicanek) design without cramping near fs/2 instead of RBJ (biquads only, no design table, see EqualizerDesign.h)
+const bool g_useSVFTopology(false); // TPT state variable filter instead of Direct Form I biquads (modulation stable, see tools/MultiChannelSVF.h)
 const bool g_forcePowerOf2(false); // should be true for FFT Processing
+const bool g_zeroLatency(true); // process the host buffer in place in slices of at most g_desired_blocksize_ms (no delay, not for FFT processing)
+const int g_nrOfBands(8); // number of peak bands in the cascade (8 ... 32)
+const int g_maxChannels(64); // largest supported bus (any discrete layout, e.g. 7.1.4 or 3rd order ambisonics)
+const int g_parallelMinChannels(16); // busses with more channels are filtered in channel groups on a worker pool
+const int g_channelsPerTask(8); // channel group size of one worker task (a multiple of the SIMD lane width of MultiChannelBiquad)
+const int g_maxWorkerThreads(3); // at most this many workers per instance (plus the audio thread)
+const int g_linearPhaseFFTSize(16384); // frame length and latency of the linear phase mode up to 48 kHz (doubled for 96 and 192 kHz)
 
 // -------------- GUI -----------------
 // global GUI setting for PeakEqualizer
@@ -10,11 +21,17 @@ const int g_minGuiSize_x(100);
 const int g_maxGuiSize_x(400);
 const int g_minGuiSize_y(300);
 const float g_guiratio = float(g_minGuiSize_y)/g_minGuiSize_x;
+const int g_responseNrOfPoints(512); // log frequency grid of the EQ curve in the GUI (see tools/FrequencyResponse.h)
+const int g_analyzerFFTSize(4096); // frame length of the spectrum analyzer (power of 2)
+const int g_guiFrameRate(30); // at most this many repaints of the EQ curve and analyzer updates (FFT) per second
+const float g_analyzerAveraging(0.7f); // exponential averaging of the power spectra per update (0: none)
+const float g_analyzerMinLevel_dB(-96.f); // bottom of the analyzer display (top is 0 dB full scale)
 
 // ---------- presethandler ----------
 //const StringArray g_PresetCategories("Unknown", "Lead", "Brass", "Template", "Bass",
 //	"Key", "Organ" , "Pad", "Drums_Perc", "SpecialEffect","Sequence", "String" );
 const juce::StringArray g_PresetCategories(""); // keep empty for "no categories"
+const int g_presetScanMaxThreads(4); // at most this many background threads parse the preset files of a new instance
 
 const int g_minPresetHandlerHeight(30); // in pixels
 #define MIN_COMBO_WITH_PRESET 120
@@ -0,0 +1,290 @@
+// headless batch renderer: processes WAV/FLAC files with PeakEqualizerAudio (no plugin host needed)
+// Usage: PeakEqualizerBatch --input <file|dir> --output <dir> [options]
+//   --preset <file.xml>            preset as saved by the plugin (PresetHandler)
+//   --band <n:gain_dB:freq_Hz:Q>   sets band n (1 ... g_nrOfBands), after the preset
+//   --bypass <n>                   bypasses band n
+//   --oversampling <1|2|4>         filters at 2 or 4 times the sampling rate (default: preset or 1)
+//   --linear-phase                 linear phase mode (FFT based, overrides the oversampling)
+//   --threads <n>                  number of worker threads (default: number of cores)
+//   --block <n>                    samples per read/process/write chunk (default 4096)
+//   --recursive                    searches the input directory recursively
+// Every file is one job on the thread pool with its own PeakEqualizerAudio instance. The files
+// are streamed in chunks of --block samples, memory per job does not depend on the file length.
+// The output has the same relative path, format, sampling rate and channels as the input (latency
+// of the processing is removed). The parameters are the same for all files (read only by the jobs).
+#include <JuceHeader.h>
+#include <atomic>
+#include <iostream>
+
+#include "PeakEqualizer.h"
+#include "PeakEqualizerParameterHost.h"
+
+namespace
+{
+    const int c_defaultBlockSize = 4096;
+    const juce::String c_fileWildcard = "*.wav;*.flac";
+
+    struct Settings
+    {
+        juce::File input;
+        juce::File output;
+        juce::File preset;
+        int nrOfThreads = juce::SystemStats::getNumCpus();
+        int blockSize = c_defaultBlockSize;
+        bool recursive = false;
+    };
+
+    // one line (written at once, the jobs run in parallel)
+    void printLine(const juce::String& text, bool isError = false)
+    {
+        (isError ? std::cerr : std::cout) << (text + "\n").toStdString() << std::flush;
+    }
+
+    void printUsage()
+    {
+        printLine("usage: PeakEqualizerBatch --input <file|dir> --output <dir> [--preset <file.xml>]\n"
+                  "       [--band <n:gain_dB:freq_Hz:Q>]... [--bypass <n>]... [--oversampling <1|2|4>]\n"
+                  "       [--linear-phase] [--threads <n>] [--block <n>] [--recursive]\n"
+                  "       bands are numbered 1 ... " + juce::String(g_nrOfBands));
+    }
+
+    class RenderJob : public juce::ThreadPoolJob
+    {
+    public:
+        RenderJob(PeakEqualizerParameterHost& host, const juce::File& inputFile, const juce::File& outputFile, int blockSize,
+                  std::atomic<int>& nrOfDone, std::atomic<int>& nrOfFailed)
+            : juce::ThreadPoolJob(inputFile.getFileName()),
+            m_host(host),
+            m_inputFile(inputFile),
+            m_outputFile(outputFile),
+            m_blockSize(blockSize),
+            m_nrOfDone(nrOfDone),
+            m_nrOfFailed(nrOfFailed)
+        {
+        }
+        JobStatus runJob() override
+        {
+            juce::String error = render();
+            if (error.isNotEmpty())
+            {
+                printLine(m_inputFile.getFullPathName() + ": " + error, true);
+                m_outputFile.deleteFile();
+                ++m_nrOfFailed;
+            }
+            ++m_nrOfDone;
+            return jobHasFinished;
+        }
+
+    private:
+        juce::String render()
+        {
+            juce::AudioFormatManager formatManager;
+            formatManager.registerBasicFormats();
+
+            std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(m_inputFile));
+            if (reader == nullptr)
+                return "unknown format or not readable";
+            auto format = formatManager.findFormatForFileExtension(m_outputFile.getFileExtension());
+            if (format == nullptr)
+                return "no writer for " + m_outputFile.getFileExtension();
+
+            int nrOfChannels = static_cast<int>(reader->numChannels);
+            double fs = reader->sampleRate;
+            juce::int64 length = reader->lengthInSamples;
+            // same bit depth as the input, if the output format can write it (e.g. FLAC has no 32 bit)
+            int bitsPerSample = static_cast<int>(reader->bitsPerSample);
+            if (!format->getPossibleBitDepths().contains(bitsPerSample))
+                bitsPerSample = 24;
+
+            if (!m_outputFile.getParentDirectory().createDirectory())
+                return "can not create " + m_outputFile.getParentDirectory().getFullPathName();
+            m_outputFile.deleteFile();
+            std::unique_ptr<juce::FileOutputStream> stream(m_outputFile.createOutputStream());
+            if (stream == nullptr || stream->failedToOpen())
+                return "can not open " + m_outputFile.getFullPathName();
+            std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), fs,
+                static_cast<unsigned int>(nrOfChannels), bitsPerSample, reader->metadataValues, 0));
+            if (writer == nullptr)
+                return "can not write " + juce::String(nrOfChannels) + " channels, " + juce::String(bitsPerSample) + " bit as " + format->getFormatName();
+            stream.release(); // owned by the writer
+
+            PeakEqualizerAudio<float> equalizer;
+            equalizer.prepareParameter(m_host.getVTS());
+            equalizer.prepareToPlay(fs, m_blockSize, nrOfChannels);
+            int latency = equalizer.getLatency();
+
+            // the first latency samples of the output are dropped, the input is padded with latency zeros
+            juce::AudioBuffer<float> buffer(nrOfChannels, m_blockSize);
+            juce::MidiBuffer midi;
+            juce::int64 totalLength = length + latency;
+            for (juce::int64 position = 0; position < totalLength; position += m_blockSize)
+            {
+                if (shouldExit())
+                    return "cancelled";
+                int blockSize = static_cast<int>(juce::jmin(static_cast<juce::int64>(m_blockSize), totalLength - position));
+                buffer.setSize(nrOfChannels, blockSize, false, false, true);
+                int nrOfRead = static_cast<int>(juce::jlimit(static_cast<juce::int64>(0), static_cast<juce::int64>(blockSize), length - position));
+                if (nrOfRead > 0 && !reader->read(&buffer, 0, nrOfRead, position, true, true))
+                    return "read error";
+                if (nrOfRead < blockSize)
+                    buffer.clear(nrOfRead, blockSize - nrOfRead);
+
+                equalizer.processBlock(buffer, midi);
+
+                int skip = static_cast<int>(juce::jlimit(static_cast<juce::int64>(0), static_cast<juce::int64>(blockSize), latency - position));
+                if (skip < blockSize && !writer->writeFromAudioSampleBuffer(buffer, skip, blockSize - skip))
+                    return "write error";
+            }
+            if (!writer->flush())
+                return "write error";
+            return {};
+        }
+
+        PeakEqualizerParameterHost& m_host;
+        juce::File m_inputFile;
+        juce::File m_outputFile;
+        int m_blockSize;
+        std::atomic<int>& m_nrOfDone;
+        std::atomic<int>& m_nrOfFailed;
+    };
+
+    // band as n:gain_dB:freq_Hz:Q (n from 1)
+    bool setBand(PeakEqualizerParameterHost& host, const juce::String& argument)
+    {
+        juce::StringArray values;
+        values.addTokens(argument, ":", "");
+        if (values.size() != 4)
+            return false;
+        return host.setBand(values[0].getIntValue() - 1, values[1].getFloatValue(), values[2].getFloatValue(), values[3].getFloatValue());
+    }
+    bool setBypass(PeakEqualizerParameterHost& host, const juce::String& argument)
+    {
+        int band = argument.getIntValue() - 1;
+        if (band < 0 || band >= g_nrOfBands)
+            return false;
+        return host.setParameter(getBandParameterID(g_paramBypass.ID, band), 1.f);
+    }
+    // factor 1, 2 or 4 to the choice index of g_paramOversampling
+    bool setOversampling(PeakEqualizerParameterHost& host, const juce::String& argument)
+    {
+        int factor = argument.getIntValue();
+        for (auto choice = 0; choice < g_paramOversampling.choices.size(); ++choice)
+            if (oversamplingChoiceToFactor(static_cast<float>(choice)) == factor)
+                return host.setParameter(g_paramOversampling.ID, static_cast<float>(choice));
+        return false;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    PeakEqualizerParameterHost host;
+    Settings settings;
+    // bands and bypass are applied after the preset, the order on the command line does not matter
+    juce::StringArray bands, bypasses;
+    juce::String oversampling;
+    bool linearPhase = false;
+    for (auto kk = 1; kk < argc; ++kk)
+    {
+        juce::String argument(argv[kk]);
+        bool hasValue = kk + 1 < argc;
+        if (argument == "--recursive")
+            settings.recursive = true;
+        else if (argument == "--linear-phase")
+            linearPhase = true;
+        else if (argument == "--input" && hasValue)
+            settings.input = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++kk]);
+        else if (argument == "--output" && hasValue)
+            settings.output = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++kk]);
+        else if (argument == "--preset" && hasValue)
+            settings.preset = juce::File::getCurrentWorkingDirectory().getChildFile(argv[++kk]);
+        else if (argument == "--threads" && hasValue)
+            settings.nrOfThreads = juce::jmax(1, juce::String(argv[++kk]).getIntValue());
+        else if (argument == "--block" && hasValue)
+            settings.blockSize = juce::jmax(64, juce::String(argv[++kk]).getIntValue());
+        else if (argument == "--band" && hasValue)
+            bands.add(argv[++kk]);
+        else if (argument == "--bypass" && hasValue)
+            bypasses.add(argv[++kk]);
+        else if (argument == "--oversampling" && hasValue)
+            oversampling = argv[++kk];
+        else
+        {
+            printUsage();
+            return 1;
+        }
+    }
+    if (settings.input == juce::File() || settings.output == juce::File() || !settings.input.exists())
+    {
+        printUsage();
+        return 1;
+    }
+    if (settings.preset != juce::File() && !host.loadPreset(settings.preset))
+    {
+        printLine("can not load preset " + settings.preset.getFullPathName(), true);
+        return 1;
+    }
+    for (const auto& band : bands)
+        if (!setBand(host, band))
+        {
+            printLine("invalid band " + band, true);
+            return 1;
+        }
+    for (const auto& bypass : bypasses)
+        if (!setBypass(host, bypass))
+        {
+            printLine("invalid band " + bypass, true);
+            return 1;
+        }
+    if (oversampling.isNotEmpty() && !setOversampling(host, oversampling))
+    {
+        printLine("invalid oversampling factor " + oversampling, true);
+        return 1;
+    }
+    if (linearPhase)
+        host.setParameter(g_paramPhase.ID, 1.f);
+
+    // a single file or all files of a directory
+    juce::File inputRoot = settings.input.isDirectory() ? settings.input : settings.input.getParentDirectory();
+    juce::Array<juce::File> files;
+    if (settings.input.isDirectory())
+        files = settings.input.findChildFiles(juce::File::findFiles, settings.recursive, c_fileWildcard);
+    else
+        files.add(settings.input);
+    if (files.isEmpty())
+    {
+        printLine("no WAV or FLAC files in " + settings.input.getFullPathName(), true);
+        return 1;
+    }
+
+    std::atomic<int> nrOfDone{0}, nrOfFailed{0};
+    {
+        juce::ThreadPool pool(juce::jmin(settings.nrOfThreads, files.size()));
+        for (const auto& file : files)
+        {
+            auto outputFile = settings.output.getChildFile(file.getRelativePathFrom(inputRoot));
+            if (outputFile == file)
+            {
+                printLine(file.getFullPathName() + ": output would overwrite the input", true);
+                ++nrOfFailed;
+                ++nrOfDone;
+                continue;
+            }
+            pool.addJob(new RenderJob(host, file, outputFile, settings.blockSize, nrOfDone, nrOfFailed), true);
+        }
+        int lastReported = -1;
+        while (nrOfDone < files.size())
+        {
+            if (nrOfDone != lastReported)
+            {
+                lastReported = nrOfDone;
+                printLine(juce::String(lastReported) + "/" + juce::String(files.size()) + " files");
+            }
+            juce::Thread::sleep(100);
+        }
+    }
+    printLine(juce::String(files.size() - nrOfFailed) + " of " + juce::String(files.size()) + " files written to "
+              + settings.output.getFullPathName());
+    return nrOfFailed > 0 ? 1 : 0;
+}
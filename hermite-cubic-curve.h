@@ -2,6 +2,9 @@
 
 Released under the 0BSD license
 https://opensource.org/licenses/0BSD
+
+Changes for the PeakEqualizer: segment lookup by binary search, batch at() for sorted inputs,
+reserve() for an allocation-free build with a fixed capacity
 */
 
 #ifndef SIGNALSMITH_MONOTONIC_CURVE_H
@@ -9,6 +12,7 @@ https://opensource.org/licenses/0BSD
 
 #include <vector>
 #include <array>
+#include <algorithm>
 #include <limits>
 #include <cmath>
 
@@ -49,6 +53,16 @@ class HermiteCubicCurve {
 	Point earliest, latest;
 	// used to collect points before assembling segments
 	std::vector<Point> points;
+	// 0: points and segments grow as needed
+	size_t capacity = 0;
+
+	// index of the last segment starting at or before x (earliest.x < x < latest.x)
+	size_t findSegment(Value x) const {
+		auto next = std::upper_bound(segments.begin(), segments.end(), x, [](Value value, const HermiteCubicSegment<Value> &segment) {
+			return value < segment.x0;
+		});
+		return next == segments.begin() ? 0 : size_t(next - segments.begin()) - 1;
+	}
 
 public:
 	enum class GradientMode {quadraticX, quadraticY, dualQuadratic, fritschCarlson};
@@ -59,12 +73,20 @@ public:
 	bool monotonic = true;
 	Value edges = 0; // By default, enforce flat edges - you can still pass the first/last point in twice to get an angled corner
 	
+	// Fixed capacity: add() and finish() never allocate afterwards (e.g. on the audio thread),
+	// points beyond maxPoints are ignored
+	void reserve(size_t maxPoints) {
+		capacity = maxPoints;
+		points.reserve(maxPoints);
+		segments.reserve(maxPoints);
+	}
 	void clear() {
 		points.resize(0);
 		Point point{0, 0, 0, false, 0, 0};
 		earliest = latest = point;
 	}
 	void add(Value x, Value y) {
+		if (capacity > 0 && points.size() >= capacity) return;
 		Point point{x, y, 0, false, 0, 0};
 		if (!points.empty()) {
 			Point &prev = points.back();
@@ -154,7 +176,7 @@ public:
 		}
 		// Create segments
 		segments.resize(0);
-		segments.reserve(points.size() - 1);
+		if (capacity == 0) segments.reserve(points.size() - 1);
 		for (size_t i = 1; i < points.size(); ++i) {
 			Point &prev = points[i - 1];
 			Point &next = points[i];
@@ -168,11 +190,30 @@ public:
 	Value at(Value x) const {
 		if (x <= earliest.x) return earliest.y;
 		if (x >= latest.x) return latest.y;
-		for (int i = (int)segments.size() - 1; i >= 0; --i) {
-			auto &segment = segments[i];
-			if (x >= segment.x0) return segment.at(x);
+		if (segments.empty()) return earliest.y;
+		return segments[findSegment(x)].at(x);
+	}
+	// Evaluates n points, ascending xs are found by walking forward from the last segment
+	// (O(n + segments) instead of O(n log segments)), others by binary search
+	void at(const Value *xs, Value *ys, size_t n) const {
+		size_t index = 0;
+		for (size_t i = 0; i < n; ++i) {
+			Value x = xs[i];
+			if (x <= earliest.x) {
+				ys[i] = earliest.y;
+			} else if (x >= latest.x) {
+				ys[i] = latest.y;
+			} else if (segments.empty()) {
+				ys[i] = earliest.y;
+			} else {
+				if (x < segments[index].x0) {
+					index = findSegment(x);
+				} else {
+					while (index + 1 < segments.size() && segments[index + 1].x0 <= x) ++index;
+				}
+				ys[i] = segments[index].at(x);
+			}
 		}
-		return earliest.y;
 	}
 };
 
@@ -0,0 +1,416 @@
+// microbenchmark of the DSP hot paths: time per sample (and cycles per sample on x86) of
+//   designPeakEqualizer (and the design table / SVF design for comparison),
+//   SynchronBlockProcessor::processBlock (rebuffering only, buffered and zero latency),
+//   PeakEqualizerAudio::processSynchronBlock (float and double, automation on/off),
+//   WOLA::processSynchronBlock (rebuffering and windowing, processWOLA does nothing),
+//   PartitionedConvolver::processBlock (FIR lengths 1024 ... 65536)
+// over host block sizes, channel counts and sampling rates.
+// Usage: PeakEqualizerBenchmark [result.json] [--quick]
+// All results are written as JSON (default benchmark.json), a summary is printed.
+#include <JuceHeader.h>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <random>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+    #endif
+    #define BENCHMARK_HAS_TSC 1
+#endif
+
+#include "PeakEqualizer.h"
+#include "PeakEqualizerParameterHost.h"
+#include "tools/PartitionedConvolver.h"
+#include "EqualizerDesign.h"
+#include "EqualizerDesignTable.h"
+
+namespace
+{
+    const int c_nrOfRuns = 5; // the fastest run is reported
+
+    struct Measurement
+    {
+        double nsPerItem = 0.0;
+        double cyclesPerItem = 0.0;
+    };
+
+    // time of one run, measured by the caller (e.g. only the processing between parameter changes)
+    struct TimedRun
+    {
+        double nrOfItems = 0.0;
+        double ns = 0.0;
+        double cycles = 0.0;
+    };
+
+    class Stopwatch
+    {
+    public:
+        void start()
+        {
+            m_start = std::chrono::steady_clock::now();
+#if BENCHMARK_HAS_TSC
+            m_startCycles = __rdtsc();
+#endif
+        }
+        // adds the time since start to run
+        void stop(TimedRun& run)
+        {
+#if BENCHMARK_HAS_TSC
+            run.cycles += static_cast<double>(__rdtsc() - m_startCycles);
+#endif
+            run.ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - m_start).count();
+        }
+    private:
+        std::chrono::steady_clock::time_point m_start;
+#if BENCHMARK_HAS_TSC
+        unsigned long long m_startCycles = 0;
+#endif
+    };
+
+    // runs func c_nrOfRuns times (after one warm up run), func returns a TimedRun with its own timing
+    template <typename Function>
+    Measurement measureTimed(Function func)
+    {
+        func();
+        Measurement best;
+        best.nsPerItem = std::numeric_limits<double>::max();
+        for (auto run = 0; run < c_nrOfRuns; ++run)
+        {
+            TimedRun timed = func();
+            if (timed.ns / timed.nrOfItems < best.nsPerItem)
+            {
+                best.nsPerItem = timed.ns / timed.nrOfItems;
+                best.cyclesPerItem = timed.cycles / timed.nrOfItems;
+            }
+        }
+        return best;
+    }
+
+    // runs func c_nrOfRuns times (after one warm up run), func returns the number of processed items
+    template <typename Function>
+    Measurement measure(Function func)
+    {
+        return measureTimed([&]()
+        {
+            TimedRun timed;
+            Stopwatch stopwatch;
+            stopwatch.start();
+            timed.nrOfItems = static_cast<double>(func());
+            stopwatch.stop(timed);
+            return timed;
+        });
+    }
+
+    void fillNoise(juce::AudioBuffer<float>& buffer, std::mt19937& generator)
+    {
+        std::uniform_real_distribution<float> distribution(-0.5f, 0.5f);
+        for (auto cc = 0; cc < buffer.getNumChannels(); ++cc)
+            for (auto kk = 0; kk < buffer.getNumSamples(); ++kk)
+                buffer.setSample(cc, kk, distribution(generator));
+    }
+    void fillNoise(juce::AudioBuffer<double>& buffer, std::mt19937& generator)
+    {
+        std::uniform_real_distribution<double> distribution(-0.5, 0.5);
+        for (auto cc = 0; cc < buffer.getNumChannels(); ++cc)
+            for (auto kk = 0; kk < buffer.getNumSamples(); ++kk)
+                buffer.setSample(cc, kk, distribution(generator));
+    }
+
+    juce::var makeResult(const juce::String& benchmark, juce::NamedValueSet parameters, const Measurement& measurement,
+                         const juce::String& unit)
+    {
+        auto object = new juce::DynamicObject();
+        object->setProperty("benchmark", benchmark);
+        for (const auto& parameter : parameters)
+            object->setProperty(parameter.name, parameter.value);
+        object->setProperty("ns_per_" + unit, measurement.nsPerItem);
+#if BENCHMARK_HAS_TSC
+        object->setProperty("cycles_per_" + unit, measurement.cyclesPerItem);
+#endif
+        return juce::var(object);
+    }
+
+    void printResult(const juce::var& result)
+    {
+        std::cout << juce::JSON::toString(result, true).toStdString() << std::endl;
+    }
+
+    // only the rebuffering is measured
+    template <typename FloatType>
+    class PassThrough : public SynchronBlockProcessor<FloatType>
+    {
+    public:
+        int processSynchronBlock(juce::AudioBuffer<FloatType>&, juce::MidiBuffer&) override {return 0;};
+    };
+    template <typename FloatType>
+    class PassThroughWOLA : public WOLA<FloatType>
+    {
+    public:
+        int processWOLA(juce::AudioBuffer<FloatType>&, juce::MidiBuffer&) override {return 0;};
+    };
+
+    // all bands active with different gains, boosts and cuts of 3 ... 9.5 dB (never 0 dB, where a band is bypassed)
+    void setAllBands(PeakEqualizerParameterHost& host, float gainOffset)
+    {
+        for (auto band = 0; band < g_nrOfBands; ++band)
+        {
+            float gain = 3.f + 0.5f * gainOffset + (band % 4);
+            host.setParameter(getBandParameterID(g_paramGain.ID, band), band % 2 == 0 ? gain : -gain);
+        }
+    }
+
+    void benchmarkDesign(juce::Array<juce::var>& results, const std::vector<double>& samplingRates)
+    {
+        const int nrOfDesigns = 100000;
+        std::vector<double> b(3), a(3);
+        for (auto fs : samplingRates)
+        {
+            PeakEqualizerDesignTable table;
+            table.build(fs);
+            double check = 0.0;
+            auto logF0 = [](int kk){return g_paramFreq.minValue + (kk % 997) * (g_paramFreq.maxValue - g_paramFreq.minValue) / 997.f;};
+            auto logQ = [](int kk){return g_paramQ.minValue + (kk % 101) * (g_paramQ.maxValue - g_paramQ.minValue) / 101.f;};
+            auto gain = [](int kk){return -20.f + (kk % 41);};
+
+            auto exact = measure([&]()
+            {
+                for (auto kk = 0; kk < nrOfDesigns; ++kk)
+                {
+                    designPeakEqualizer(b, a, exp(logF0(kk)), exp(logQ(kk)), gain(kk), fs);
+                    check += b[0];
+                }
+                return nrOfDesigns;
+            });
+            auto interpolated = measure([&]()
+            {
+                for (auto kk = 0; kk < nrOfDesigns; ++kk)
+                {
+                    table.design(b, a, logF0(kk), logQ(kk), gain(kk));
+                    check += b[0];
+                }
+                return nrOfDesigns;
+            });
+            auto svf = measure([&]()
+            {
+                double g, k, m1;
+                for (auto kk = 0; kk < nrOfDesigns; ++kk)
+                {
+                    designPeakEqualizerSVF(g, k, m1, exp(logF0(kk)), exp(logQ(kk)), gain(kk), fs);
+                    check += g;
+                }
+                return nrOfDesigns;
+            });
+            juce::ignoreUnused(check);
+
+            juce::NamedValueSet parameters;
+            parameters.set("fs", fs);
+            parameters.set("method", "designPeakEqualizer");
+            results.add(makeResult("design", parameters, exact, "design"));
+            parameters.set("method", "PeakEqualizerDesignTable");
+            results.add(makeResult("design", parameters, interpolated, "design"));
+            parameters.set("method", "designPeakEqualizerSVF");
+            results.add(makeResult("design", parameters, svf, "design"));
+        }
+    }
+
+    void benchmarkSynchronBlockProcessor(juce::Array<juce::var>& results, const std::vector<double>& samplingRates,
+                                         const std::vector<int>& hostBlockSizes, const std::vector<int>& channelCounts,
+                                         int nrOfSamples)
+    {
+        std::mt19937 generator(1);
+        for (auto fs : samplingRates)
+        for (auto channels : channelCounts)
+        for (auto hostBlockSize : hostBlockSizes)
+        for (auto zeroLatency : {false, true})
+        {
+            PassThrough<float> processor;
+            int synchronBlockSize = static_cast<int>(round(0.001 * g_desired_blocksize_ms * fs));
+            processor.prepareSynchronProcessing(channels, synchronBlockSize, zeroLatency);
+            juce::AudioBuffer<float> buffer(channels, hostBlockSize);
+            juce::MidiBuffer midi;
+            fillNoise(buffer, generator);
+            int nrOfBlocks = juce::jmax(1, nrOfSamples / hostBlockSize);
+
+            auto result = measure([&]()
+            {
+                for (auto kk = 0; kk < nrOfBlocks; ++kk)
+                    processor.processBlock(buffer, midi);
+                return nrOfBlocks * hostBlockSize;
+            });
+            juce::NamedValueSet parameters;
+            parameters.set("fs", fs);
+            parameters.set("channels", channels);
+            parameters.set("host_block_size", hostBlockSize);
+            parameters.set("synchron_block_size", synchronBlockSize);
+            parameters.set("zero_latency", zeroLatency);
+            results.add(makeResult("SynchronBlockProcessor::processBlock", parameters, result, "sample"));
+        }
+    }
+
+    template <typename FloatType>
+    void benchmarkPeakEqualizer(juce::Array<juce::var>& results, PeakEqualizerParameterHost& host, const std::vector<double>& samplingRates,
+                                const std::vector<int>& channelCounts, int nrOfSamples)
+    {
+        std::mt19937 generator(2);
+        for (auto fs : samplingRates)
+        for (auto channels : channelCounts)
+        for (auto automation : {false, true})
+        {
+            setAllBands(host, 0.f);
+            PeakEqualizerAudio<FloatType> equalizer;
+            equalizer.prepareParameter(host.getVTS());
+            equalizer.prepareToPlay(fs, 1024, channels);
+            int synchronBlockSize = static_cast<int>(round(0.001 * g_desired_blocksize_ms * fs));
+            juce::AudioBuffer<FloatType> buffer(channels, synchronBlockSize);
+            juce::MidiBuffer midi;
+            fillNoise(buffer, generator);
+            int nrOfBlocks = juce::jmax(1, nrOfSamples / synchronBlockSize);
+            // automation: the gains move every 16 blocks (the smoothers and coefficient ramps are always busy)
+            int automationCounter = 0;
+
+            // the parameter changes are not part of the processing time
+            auto result = measureTimed([&]()
+            {
+                TimedRun timed;
+                Stopwatch stopwatch;
+                for (auto kk = 0; kk < nrOfBlocks; ++kk)
+                {
+                    if (automation && kk % 16 == 0)
+                        setAllBands(host, static_cast<float>((++automationCounter) % 8));
+                    stopwatch.start();
+                    equalizer.processSynchronBlock(buffer, midi);
+                    stopwatch.stop(timed);
+                }
+                timed.nrOfItems = nrOfBlocks * synchronBlockSize;
+                return timed;
+            });
+            juce::NamedValueSet parameters;
+            parameters.set("fs", fs);
+            parameters.set("channels", channels);
+            parameters.set("precision", sizeof(FloatType) == sizeof(float) ? "float" : "double");
+            parameters.set("bands", g_nrOfBands);
+            parameters.set("synchron_block_size", synchronBlockSize);
+            parameters.set("automation", automation);
+            results.add(makeResult("PeakEqualizerAudio::processSynchronBlock", parameters, result, "sample"));
+        }
+    }
+
+    void benchmarkWOLA(juce::Array<juce::var>& results, const std::vector<int>& hostBlockSizes,
+                       const std::vector<int>& channelCounts, int nrOfSamples)
+    {
+        using WinType = WOLA<float>::WinType;
+        std::mt19937 generator(3);
+        for (auto nrOfOverlaps : {2, 4, 8})
+        for (auto fftSize : {512, 2048})
+        for (auto channels : channelCounts)
+        for (auto hostBlockSize : hostBlockSizes)
+        {
+            PassThroughWOLA<float> wola;
+            wola.prepareWOLAprocessing(channels, fftSize, nrOfOverlaps, WinType::SqrtHann, WinType::SqrtHann);
+            juce::AudioBuffer<float> buffer(channels, hostBlockSize);
+            juce::MidiBuffer midi;
+            fillNoise(buffer, generator);
+            int nrOfBlocks = juce::jmax(1, nrOfSamples / hostBlockSize);
+
+            auto result = measure([&]()
+            {
+                for (auto kk = 0; kk < nrOfBlocks; ++kk)
+                    wola.processBlock(buffer, midi);
+                return nrOfBlocks * hostBlockSize;
+            });
+            juce::NamedValueSet parameters;
+            parameters.set("overlap", 100.0 - 100.0 / nrOfOverlaps);
+            parameters.set("fft_size", fftSize);
+            parameters.set("channels", channels);
+            parameters.set("host_block_size", hostBlockSize);
+            results.add(makeResult("WOLA::processSynchronBlock", parameters, result, "sample"));
+        }
+    }
+
+    void benchmarkPartitionedConvolver(juce::Array<juce::var>& results, const std::vector<double>& samplingRates,
+                                       const std::vector<int>& channelCounts, int nrOfSamples)
+    {
+        std::mt19937 generator(4);
+        std::uniform_real_distribution<float> distribution(-0.01f, 0.01f);
+        const int hostBlockSize = 512;
+        for (auto fs : samplingRates)
+        for (auto firLength : {1024, 4096, 16384, 65536})
+        for (auto channels : channelCounts)
+        {
+            PartitionedConvolver<float> convolver;
+            convolver.prepare(channels, fs, firLength);
+            std::vector<float> fir(firLength);
+            for (auto& tap : fir)
+                tap = distribution(generator);
+            for (auto cc = 0; cc < channels; ++cc)
+                convolver.setFIR(cc, fir.data(), firLength);
+            juce::AudioBuffer<float> buffer(channels, hostBlockSize);
+            juce::MidiBuffer midi;
+            fillNoise(buffer, generator);
+            int nrOfBlocks = juce::jmax(1, nrOfSamples / hostBlockSize);
+
+            auto result = measure([&]()
+            {
+                for (auto kk = 0; kk < nrOfBlocks; ++kk)
+                    convolver.processBlock(buffer, midi);
+                return nrOfBlocks * hostBlockSize;
+            });
+            juce::NamedValueSet parameters;
+            parameters.set("fs", fs);
+            parameters.set("fir_length", firLength);
+            parameters.set("partition_size", convolver.getPartitionSize());
+            parameters.set("channels", channels);
+            results.add(makeResult("PartitionedConvolver::processBlock", parameters, result, "sample"));
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::String outputFile = "benchmark.json";
+    bool quick = false;
+    for (auto kk = 1; kk < argc; ++kk)
+    {
+        juce::String argument(argv[kk]);
+        if (argument == "--quick")
+            quick = true;
+        else
+            outputFile = argument;
+    }
+
+    std::vector<double> samplingRates = quick ? std::vector<double>{48000.0} : std::vector<double>{44100.0, 48000.0, 96000.0};
+    std::vector<int> hostBlockSizes = quick ? std::vector<int>{64, 512} : std::vector<int>{32, 64, 128, 256, 512, 1024};
+    std::vector<int> channelCounts = quick ? std::vector<int>{2} : std::vector<int>{1, 2, 8};
+    int nrOfSamples = quick ? 48000 : 480000;
+
+    juce::Array<juce::var> results;
+    PeakEqualizerParameterHost host;
+    benchmarkDesign(results, samplingRates);
+    benchmarkSynchronBlockProcessor(results, samplingRates, hostBlockSizes, channelCounts, nrOfSamples);
+    benchmarkPeakEqualizer<float>(results, host, samplingRates, channelCounts, nrOfSamples);
+    benchmarkPeakEqualizer<double>(results, host, samplingRates, channelCounts, nrOfSamples);
+    benchmarkWOLA(results, hostBlockSizes, channelCounts, nrOfSamples);
+    benchmarkPartitionedConvolver(results, samplingRates, channelCounts, nrOfSamples);
+
+    for (const auto& result : results)
+        printResult(result);
+
+    auto root = new juce::DynamicObject();
+    root->setProperty("version", ProjectInfo::versionString);
+    root->setProperty("nr_of_bands", g_nrOfBands);
+    root->setProperty("synchron_block_ms", g_desired_blocksize_ms);
+    root->setProperty("results", results);
+    juce::File file = juce::File::getCurrentWorkingDirectory().getChildFile(outputFile);
+    if (!file.replaceWithText(juce::JSON::toString(juce::var(root))))
+    {
+        std::cerr << "could not write " << file.getFullPathName().toStdString() << std::endl;
+        return 1;
+    }
+    std::cout << "results written to " << file.getFullPathName().toStdString() << std::endl;
+    return 0;
+}
@@ -0,0 +1,60 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <vector>
+
+#include "../../EqualizerDesignTable.h"
+
+// magnitude in dB of the biquad at normalized frequency w
+double magnitudedB(const std::vector<double>& b, const std::vector<double>& a, double w)
+{
+    std::complex<double> z1 = std::polar(1.0, -w);
+    std::complex<double> z2 = z1*z1;
+    std::complex<double> H = (b[0] + b[1]*z1 + b[2]*z2)/(a[0] + a[1]*z1 + a[2]*z2);
+    return 20.0*log10(std::abs(H));
+}
+
+int main()
+{
+    std::vector<double> fsList = {44100.0, 48000.0, 96000.0, 192000.0};
+    std::vector<double> bExact, aExact, bTable, aTable;
+    // the error grows towards fs/2 (small sin(w0)), therefore two frequency limits
+    std::vector<double> maxF0List = {0.4, 0.49};
+    for (auto fs : fsList)
+    for (auto maxF0 : maxF0List)
+    {
+        PeakEqualizerDesignTable table;
+        table.build(fs);
+
+        double maxCoeffError = 0.0;
+        double maxMagError = 0.0;
+        // off-grid parameters over the full range
+        for (double logF0 = log(50.0) + 0.0013; logF0 < log(maxF0*fs); logF0 += 0.0517)
+        {
+            for (double logQ = log(0.1) + 0.0007; logQ < log(10.0); logQ += 0.213)
+            {
+                for (double gain = -23.97; gain < 24.0; gain += 2.31)
+                {
+                    designPeakEqualizer(bExact, aExact, exp(logF0), exp(logQ), gain, fs);
+                    table.design(bTable, aTable, logF0, logQ, gain);
+                    for (auto kk = 0; kk < 3; ++kk)
+                    {
+                        maxCoeffError = std::max(maxCoeffError, std::abs(bExact[kk] - bTable[kk]));
+                        maxCoeffError = std::max(maxCoeffError, std::abs(aExact[kk] - aTable[kk]));
+                    }
+                    // response at the center frequency and at the band edges
+                    double w0 = 2.0*M_PI*exp(logF0)/fs;
+                    for (double w : {0.5*w0, w0, std::min(1.5*w0, M_PI)})
+                    {
+                        double err = std::abs(magnitudedB(bExact, aExact, w) - magnitudedB(bTable, aTable, w));
+                        maxMagError = std::max(maxMagError, err);
+                    }
+                }
+            }
+        }
+        std::cout << "fs = " << fs << ", f0 <= " << maxF0 << "*fs: max coefficient error = " << maxCoeffError
+                  << ", max magnitude error = " << maxMagError << " dB" << std::endl;
+    }
+    return 0;
+}
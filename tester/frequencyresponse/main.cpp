@@ -0,0 +1,96 @@
+#define _USE_MATH_DEFINES
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "../../EqualizerDesign.h"
+#include "../../tools/FrequencyResponse.h"
+
+// reference: H of the cascade in double precision at frequency f
+std::complex<double> cascadeResponse(const std::vector<std::vector<double>>& b, const std::vector<std::vector<double>>& a, double f, double fs)
+{
+    std::complex<double> z1 = std::polar(1.0, -2.0*M_PI*f/fs);
+    std::complex<double> z2 = z1*z1;
+    std::complex<double> H = 1.0;
+    for (size_t section = 0; section < b.size(); ++section)
+        H *= (b[section][0] + b[section][1]*z1 + b[section][2]*z2)/(a[section][0] + a[section][1]*z1 + a[section][2]*z2);
+    return H;
+}
+
+// time of one update in us after changing nrOfChanged sections
+double updateTime(FrequencyResponse& response, int nrOfChanged, double fs)
+{
+    const int nrOfUpdates = 10000;
+    std::vector<double> b, a;
+    auto start = std::chrono::steady_clock::now();
+    for (auto kk = 0; kk < nrOfUpdates; ++kk)
+    {
+        for (auto section = 0; section < nrOfChanged; ++section)
+        {
+            designPeakEqualizer(b, a, 100.0 + section*1000.0 + (kk % 100), 1.0, 6.0, fs);
+            response.setCoefficients(section, b, a);
+        }
+        response.update();
+    }
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(stop - start).count()/nrOfUpdates;
+}
+
+int main()
+{
+    const int nrOfPoints = 512;
+    const int nrOfSections = 8;
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<double> logF0(log(50.0), log(15000.0));
+    std::uniform_real_distribution<double> logQ(log(0.1), log(10.0));
+    std::uniform_real_distribution<double> gain(-24.0, 24.0);
+
+    FrequencyResponse response;
+    response.prepare(nrOfPoints, 20.0, 20000.0, nrOfSections);
+    for (double fs : {44100.0, 96000.0})
+    {
+        response.setSampleRate(fs);
+        double maxMagnitudeError = 0.0;
+        double maxPhaseError = 0.0;
+        // random cascades, some sections inactive
+        for (auto trial = 0; trial < 100; ++trial)
+        {
+            std::vector<std::vector<double>> bActive, aActive;
+            for (auto section = 0; section < nrOfSections; ++section)
+            {
+                std::vector<double> b, a;
+                designPeakEqualizer(b, a, exp(logF0(generator)), exp(logQ(generator)), gain(generator), fs);
+                response.setCoefficients(section, b, a);
+                bool isActive = (generator() % 4) != 0;
+                response.setSectionActive(section, isActive);
+                if (isActive)
+                {
+                    bActive.push_back(b);
+                    aActive.push_back(a);
+                }
+            }
+            response.update();
+            const auto& frequencies = response.getFrequencies();
+            for (auto kk = 0; kk < nrOfPoints; ++kk)
+            {
+                auto H = cascadeResponse(bActive, aActive, frequencies[kk], fs);
+                maxMagnitudeError = std::max(maxMagnitudeError, std::abs(20.0*log10(std::abs(H)) - response.getMagnitude_dB()[kk]));
+                // wrapped phase difference
+                maxPhaseError = std::max(maxPhaseError, std::abs(std::arg(H*std::polar(1.0, -static_cast<double>(response.getPhase()[kk])))));
+            }
+        }
+        std::cout << "fs = " << fs << ": max magnitude error = " << maxMagnitudeError
+                  << " dB, max phase error = " << maxPhaseError << " rad" << std::endl;
+    }
+
+    // all sections active, only the changed ones are evaluated again
+    for (auto section = 0; section < nrOfSections; ++section)
+        response.setSectionActive(section, true);
+    std::cout << nrOfPoints << " points, " << nrOfSections << " sections: update with 1 changed section = "
+              << updateTime(response, 1, 48000.0) << " us, with all changed = "
+              << updateTime(response, nrOfSections, 48000.0) << " us" << std::endl;
+    return 0;
+}
@@ -0,0 +1,161 @@
+// checks the lookup of HermiteCubicCurve (hermite-cubic-curve.h) against the original linear scan:
+// - at(x) and the batch at(xs, ys, n) must give exactly the values of the linear scan, for random
+//   curves with peaks and repeated x values (angled corners), all gradient modes, x values on the
+//   knots and outside the curve, ascending, descending and unsorted batch inputs
+// - after reserve(maxPoints) clear, add, finish and at must not allocate
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "../../hermite-cubic-curve.h"
+
+// counts the allocations of the whole program (the tests compare the count before and after)
+std::atomic<long> g_nrOfAllocations{0};
+
+void* operator new(std::size_t size)
+{
+    ++g_nrOfAllocations;
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+    throw std::bad_alloc();
+}
+void operator delete(void* pointer) noexcept {std::free(pointer);}
+void operator delete(void* pointer, std::size_t) noexcept {std::free(pointer);}
+
+// the lookup of the original header: the last segment that starts at or before x
+double linearScanAt(const HermiteCubicCurve<double>& curve, double x, double earliestX, double earliestY, double latestX, double latestY)
+{
+    if (x <= earliestX) return earliestY;
+    if (x >= latestX) return latestY;
+    for (int i = static_cast<int>(curve.segments.size()) - 1; i >= 0; --i)
+    {
+        auto& segment = curve.segments[i];
+        if (x >= segment.x0) return segment.at(x);
+    }
+    return earliestY;
+}
+
+struct Knots
+{
+    std::vector<double> x, y;
+};
+
+// ascending x with some repeated values, y with peaks
+Knots createKnots(std::mt19937& generator, int nrOfKnots)
+{
+    std::uniform_real_distribution<double> step(0.01, 1.0);
+    std::uniform_real_distribution<double> value(-24.0, 24.0);
+    std::bernoulli_distribution repeat(0.15);
+    Knots knots;
+    double x = -5.0;
+    for (auto kk = 0; kk < nrOfKnots; ++kk)
+    {
+        if (kk == 0 || !repeat(generator))
+            x += step(generator);
+        knots.x.push_back(x);
+        knots.y.push_back(value(generator));
+    }
+    return knots;
+}
+
+// x values on the knots, between them and outside the curve
+std::vector<double> createInputs(std::mt19937& generator, const Knots& knots)
+{
+    std::uniform_real_distribution<double> position(knots.x.front() - 1.0, knots.x.back() + 1.0);
+    std::vector<double> xs(knots.x);
+    for (auto kk = 0; kk < 2000; ++kk)
+        xs.push_back(position(generator));
+    return xs;
+}
+
+int main()
+{
+    std::mt19937 generator(1);
+    int nrOfFailures = 0;
+    const int nrOfCurves = 200;
+
+    int nrOfDifferences = 0;
+    int nrOfBatchDifferences = 0;
+    for (auto curveIndex = 0; curveIndex < nrOfCurves; ++curveIndex)
+    {
+        auto knots = createKnots(generator, 2 + curveIndex % 40);
+        HermiteCubicCurve<double> curve;
+        curve.mode = static_cast<HermiteCubicCurve<double>::GradientMode>(curveIndex % 4);
+        curve.monotonic = (curveIndex / 4) % 2 == 0;
+        curve.clear();
+        for (size_t kk = 0; kk < knots.x.size(); ++kk)
+            curve.add(knots.x[kk], knots.y[kk]);
+        curve.finish();
+
+        auto xs = createInputs(generator, knots);
+        std::vector<double> expected;
+        for (auto x : xs)
+        {
+            expected.push_back(linearScanAt(curve, x, knots.x.front(), knots.y.front(), knots.x.back(), knots.y.back()));
+            if (curve.at(x) != expected.back())
+                ++nrOfDifferences;
+        }
+
+        // unsorted, ascending and descending batches
+        std::vector<size_t> order(xs.size());
+        for (size_t kk = 0; kk < order.size(); ++kk)
+            order[kk] = kk;
+        for (auto sorting = 0; sorting < 3; ++sorting)
+        {
+            if (sorting == 1)
+                std::sort(order.begin(), order.end(), [&xs](size_t left, size_t right) {return xs[left] < xs[right];});
+            if (sorting == 2)
+                std::reverse(order.begin(), order.end());
+            std::vector<double> batchXs, batchYs(xs.size());
+            for (auto index : order)
+                batchXs.push_back(xs[index]);
+            curve.at(batchXs.data(), batchYs.data(), batchXs.size());
+            for (size_t kk = 0; kk < order.size(); ++kk)
+                if (batchYs[kk] != expected[order[kk]])
+                    ++nrOfBatchDifferences;
+        }
+    }
+    std::cout << (nrOfDifferences == 0 ? "ok    " : "FAILED") << " at(x) against the linear scan: "
+              << nrOfDifferences << " differences" << std::endl;
+    std::cout << (nrOfBatchDifferences == 0 ? "ok    " : "FAILED") << " batch at (unsorted, ascending, descending) against the linear scan: "
+              << nrOfBatchDifferences << " differences" << std::endl;
+    nrOfFailures += (nrOfDifferences == 0 ? 0 : 1) + (nrOfBatchDifferences == 0 ? 0 : 1);
+
+    // fixed capacity: rebuilding and evaluating the curve does not allocate
+    const size_t maxPoints = 64;
+    HermiteCubicCurve<double> curve;
+    curve.reserve(maxPoints);
+    std::vector<Knots> curves;
+    std::vector<std::vector<double>> inputs;
+    for (auto kk = 0; kk < 20; ++kk)
+    {
+        curves.push_back(createKnots(generator, 2 + kk*4));
+        inputs.push_back(createInputs(generator, curves.back()));
+    }
+    std::vector<double> ys(inputs.front().size() + 4*maxPoints);
+    double sum = 0.0;
+    long nrOfAllocations = g_nrOfAllocations.load();
+    for (size_t curveIndex = 0; curveIndex < curves.size(); ++curveIndex)
+    {
+        // more points than the capacity are ignored
+        curve.clear();
+        for (size_t kk = 0; kk < curves[curveIndex].x.size(); ++kk)
+            curve.add(curves[curveIndex].x[kk], curves[curveIndex].y[kk]);
+        curve.finish();
+        for (auto x : inputs[curveIndex])
+            sum += curve.at(x);
+        curve.at(inputs[curveIndex].data(), ys.data(), inputs[curveIndex].size());
+        sum += ys.front();
+    }
+    nrOfAllocations = g_nrOfAllocations.load() - nrOfAllocations;
+    bool ok = nrOfAllocations == 0 && curve.segments.size() < maxPoints;
+    std::cout << (ok ? "ok    " : "FAILED") << " no allocation after reserve(" << maxPoints << "): "
+              << nrOfAllocations << " allocations (checksum " << sum << ")" << std::endl;
+    nrOfFailures += ok ? 0 : 1;
+
+    return nrOfFailures == 0 ? 0 : 1;
+}
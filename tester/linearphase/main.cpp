@@ -0,0 +1,133 @@
+// measures the linear phase mode (LinearPhaseFilter) against the intended magnitude response:
+// - time invariance: impulse responses measured at different positions within a hop must be equal
+//   (circular convolution with time aliasing would make the output depend on the frame position)
+// - magnitude error of the measured impulse response against the biquad designs
+// - symmetry of the impulse response around the latency (linear phase)
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <vector>
+
+#include <JuceHeader.h>
+#include "../../EqualizerDesign.h"
+#include "../../tools/LinearPhaseFilter.h"
+
+struct Band
+{
+    double f0, Q, gain;
+};
+
+// response of the filter to an impulse at position impulsePosition (processed in blocks of blockSize)
+std::vector<double> measureImpulseResponse(LinearPhaseFilter<double>& filter, int impulsePosition, int length, int blockSize)
+{
+    std::vector<double> response;
+    juce::AudioBuffer<double> block(1, blockSize);
+    juce::MidiBuffer midi;
+    for (auto position = 0; position < impulsePosition + length; position += blockSize)
+    {
+        block.clear();
+        if (impulsePosition >= position && impulsePosition < position + blockSize)
+            block.getWritePointer(0)[impulsePosition - position] = 1.0;
+        filter.processBlock(block, midi);
+        for (auto kk = 0; kk < blockSize; ++kk)
+            response.push_back(block.getReadPointer(0)[kk]);
+    }
+    return std::vector<double>(response.begin() + impulsePosition, response.begin() + impulsePosition + length);
+}
+
+double cascadeMagnitude_dB(const std::vector<std::vector<double>>& b, const std::vector<std::vector<double>>& a, double w)
+{
+    std::complex<double> z1 = std::polar(1.0, -w);
+    std::complex<double> H = 1.0;
+    for (size_t section = 0; section < b.size(); ++section)
+        H *= (b[section][0] + b[section][1]*z1 + b[section][2]*z1*z1)/(a[section][0] + a[section][1]*z1 + a[section][2]*z1*z1);
+    return 20.0*log10(std::abs(H));
+}
+
+// returns 1 if the test failed, maxError_dB < 0: the magnitude error is only reported
+int testCascade(const char* name, const std::vector<Band>& bands, double fs, int fftSize, double maxError_dB)
+{
+    LinearPhaseFilter<double> filter;
+    filter.prepare(1, fftSize, static_cast<int>(bands.size()));
+    std::vector<std::vector<double>> b(bands.size()), a(bands.size());
+    for (size_t section = 0; section < bands.size(); ++section)
+    {
+        designPeakEqualizer(b[section], a[section], bands[section].f0, bands[section].Q, bands[section].gain, fs);
+        filter.setCoefficients(static_cast<int>(section), b[section], a[section]);
+        filter.setSectionActive(static_cast<int>(section), true);
+    }
+    int latency = filter.getLatency();
+    int length = latency + fftSize;
+
+    // impulses at different positions within a hop and different host block sizes
+    auto reference = measureImpulseResponse(filter, 0, length, 512);
+    double maxDifference = 0.0;
+    double peak = 0.0;
+    for (auto value : reference)
+        peak = std::max(peak, std::abs(value));
+    int hopSize = filter.getHopSize();
+    for (int impulsePosition : {hopSize/3, hopSize/2 + 17, hopSize - 1})
+    {
+        filter.prepare(1, fftSize, static_cast<int>(bands.size()));
+        for (size_t section = 0; section < bands.size(); ++section)
+        {
+            filter.setCoefficients(static_cast<int>(section), b[section], a[section]);
+            filter.setSectionActive(static_cast<int>(section), true);
+        }
+        auto response = measureImpulseResponse(filter, impulsePosition, length, 333);
+        for (auto kk = 0; kk < length; ++kk)
+            maxDifference = std::max(maxDifference, std::abs(response[kk] - reference[kk]));
+    }
+    double timeVariance_dB = 20.0*log10(maxDifference/peak + 1e-30);
+
+    double maxAsymmetry = 0.0;
+    for (auto kk = 1; kk < latency && latency + kk < length; ++kk)
+        maxAsymmetry = std::max(maxAsymmetry, std::abs(reference[latency + kk] - reference[latency - kk]));
+
+    // magnitude on a logarithmic grid 20 Hz ... 20 kHz (DTFT of the measured response)
+    double maxError = 0.0;
+    double errorFrequency = 0.0;
+    for (auto kk = 0; kk < 200; ++kk)
+    {
+        double f = 20.0*pow(1000.0, kk/199.0);
+        if (f >= 0.5*fs)
+            break;
+        double w = 2.0*M_PI*f/fs;
+        std::complex<double> H = 0.0;
+        for (auto nn = 0; nn < length; ++nn)
+            H += reference[nn]*std::polar(1.0, -w*(nn - latency));
+        double error = std::abs(20.0*log10(std::abs(H)) - cascadeMagnitude_dB(b, a, w));
+        if (error > maxError)
+        {
+            maxError = error;
+            errorFrequency = f;
+        }
+    }
+
+    // the output must not depend on the frame position (the float FFT reaches about -130 dB,
+    // time aliasing of narrow bass bands showed up at -97 dB)
+    bool ok = timeVariance_dB < -110.0 && maxAsymmetry < 1e-5*peak && (maxError_dB < 0.0 || maxError <= maxError_dB);
+    std::cout << (ok ? "ok    " : "FAILED") << " " << name << " (fs " << fs << ", fft " << fftSize << "): latency " << latency
+              << ", time variance " << timeVariance_dB << " dB, asymmetry " << maxAsymmetry
+              << ", max magnitude error " << maxError << " dB at " << errorFrequency << " Hz" << std::endl;
+    return ok ? 0 : 1;
+}
+
+int main()
+{
+    int nrOfFailures = 0;
+    const int fftSize = 16384;
+    nrOfFailures += testCascade("1 kHz, Q 2, +12 dB", {{1000.0, 2.0, 12.0}}, 48000.0, fftSize, 0.01);
+    nrOfFailures += testCascade("15 kHz, Q 0.5, -24 dB", {{15000.0, 0.5, -24.0}}, 48000.0, fftSize, 0.01);
+    nrOfFailures += testCascade("100 Hz, Q 4, -12 dB", {{100.0, 4.0, -12.0}}, 48000.0, fftSize, 0.1);
+    nrOfFailures += testCascade("8 bands", {{60.0, 1.0, 6.0}, {150.0, 2.0, -6.0}, {400.0, 1.0, 4.0}, {1000.0, 3.0, -9.0},
+        {2500.0, 1.0, 5.0}, {5000.0, 4.0, -12.0}, {9000.0, 1.0, 8.0}, {16000.0, 0.7, -6.0}}, 48000.0, fftSize, 0.1);
+    nrOfFailures += testCascade("1 kHz, Q 2, +12 dB", {{1000.0, 2.0, 12.0}}, 96000.0, 2*fftSize, 0.01);
+    // below the frequency resolution of the kernel, reported only
+    nrOfFailures += testCascade("50 Hz, Q 10, +12 dB", {{50.0, 10.0, 12.0}}, 48000.0, fftSize, -1.0);
+
+    if (nrOfFailures == 0)
+        std::cout << "all tests passed" << std::endl;
+    return nrOfFailures == 0 ? 0 : 1;
+}
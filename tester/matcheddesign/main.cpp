@@ -0,0 +1,122 @@
+#define _USE_MATH_DEFINES
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <vector>
+
+#include "../../EqualizerDesign.h"
+
+// magnitude in dB of the biquad at normalized frequency w
+double magnitudedB(const std::vector<double>& b, const std::vector<double>& a, double w)
+{
+    std::complex<double> z1 = std::polar(1.0, -w);
+    std::complex<double> z2 = z1*z1;
+    std::complex<double> H = (b[0] + b[1]*z1 + b[2]*z2)/(a[0] + a[1]*z1 + a[2]*z2);
+    return 20.0*log10(std::abs(H));
+}
+
+// magnitude in dB of the analog prototype at frequency f
+double analogMagnitudedB(double f, double f0, double Q, double gain)
+{
+    double A = pow(10.0, gain/40.0);
+    std::complex<double> s(0.0, f/f0);
+    return 20.0*log10(std::abs((s*s + s*A/Q + 1.0)/(s*s + s/(A*Q) + 1.0)));
+}
+
+typedef EqualizerErrorCode (*DesignFunction)(std::vector<double>&, std::vector<double>&, double, double, double, double);
+
+// largest deviation from the analog prototype (up to fs/2) over the parameter range (gain -24 ... 24 dB)
+double maxMagnitudeError(DesignFunction design, double fs, double maxF0, double minQ)
+{
+    std::vector<double> b, a;
+    double maxError = 0.0;
+    for (double logF0 = log(50.0); logF0 < log(maxF0); logF0 += 0.0517)
+    {
+        double f0 = exp(logF0);
+        for (double logQ = log(minQ); logQ < log(10.0); logQ += 0.213)
+        {
+            for (double gain = -24.0; gain <= 24.0; gain += 3.0)
+            {
+                design(b, a, f0, exp(logQ), gain, fs);
+                // 200 log spaced frequencies from 20 Hz to fs/2
+                for (auto kk = 0; kk < 200; ++kk)
+                {
+                    double f = 20.0*pow(0.5*fs/20.0, kk/199.0);
+                    double err = std::abs(magnitudedB(b, a, 2.0*M_PI*f/fs) - analogMagnitudedB(f, f0, exp(logQ), gain));
+                    maxError = std::max(maxError, err);
+                }
+            }
+        }
+    }
+    return maxError;
+}
+
+// time of one design in ns (the parameter changes every call)
+double designTime(DesignFunction design, double fs)
+{
+    const int nrOfDesigns = 1000000;
+    std::vector<double> b(3), a(3);
+    double sum = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (auto kk = 0; kk < nrOfDesigns; ++kk)
+    {
+        design(b, a, 50.0 + (kk % 1000)*15.0, 0.5 + (kk % 7), -12.0 + (kk % 25), fs);
+        sum += b[0];
+    }
+    auto stop = std::chrono::steady_clock::now();
+    // keeps the loop
+    if (sum == 0.0)
+        std::cout << sum;
+    return std::chrono::duration<double, std::nano>(stop - start).count()/nrOfDesigns;
+}
+
+struct ErrorBound
+{
+    double minQ, maxF0, maxError;
+};
+
+// the deviations stated in EqualizerDesign.h (measured maximum of 44.1, 48 and 96 kHz, rounded up)
+const std::vector<ErrorBound> c_matchedBounds = {
+    {0.1, 0.1, 3.6}, {0.1, 0.25, 4.7}, {0.1, 0.45, 8.5},
+    {0.5, 0.1, 2.8}, {0.5, 0.25, 4.7}, {0.5, 0.45, 8.5}};
+
+int main()
+{
+    int nrOfFailures = 0;
+    std::vector<double> fsList = {44100.0, 48000.0, 96000.0};
+    // the bilinear design cramps towards fs/2, very broad bands (Q = 0.1) reach fs/2 even for low f0
+    for (auto fs : fsList)
+    for (const auto& bound : c_matchedBounds)
+    {
+        double errorRBJ = maxMagnitudeError(designPeakEqualizer, fs, bound.maxF0*fs, bound.minQ);
+        double errorMatched = maxMagnitudeError(designPeakEqualizerMatched, fs, bound.maxF0*fs, bound.minQ);
+        bool ok = errorMatched <= bound.maxError && errorMatched < errorRBJ;
+        nrOfFailures += ok ? 0 : 1;
+        std::cout << (ok ? "ok    " : "FAILED") << " fs = " << fs << ", Q >= " << bound.minQ << ", f0 <= " << bound.maxF0
+                  << "*fs: max magnitude error (20 Hz ... fs/2) RBJ = " << errorRBJ << " dB, matched = "
+                  << errorMatched << " dB (bound " << bound.maxError << " dB)" << std::endl;
+    }
+
+    // one example: +12 dB at 15 kHz, Q = 2, fs = 44.1 kHz
+    std::vector<double> bRBJ, aRBJ, bMatched, aMatched;
+    double fs = 44100.0;
+    designPeakEqualizer(bRBJ, aRBJ, 15000.0, 2.0, 12.0, fs);
+    designPeakEqualizerMatched(bMatched, aMatched, 15000.0, 2.0, 12.0, fs);
+    std::cout << "+12 dB at 15 kHz, Q = 2, fs = 44.1 kHz" << std::endl;
+    for (double f : {5000.0, 10000.0, 15000.0, 18000.0, 20000.0, 22000.0})
+    {
+        std::cout << "  " << f << " Hz: analog = " << analogMagnitudedB(f, 15000.0, 2.0, 12.0)
+                  << " dB, RBJ = " << magnitudedB(bRBJ, aRBJ, 2.0*M_PI*f/fs)
+                  << " dB, matched = " << magnitudedB(bMatched, aMatched, 2.0*M_PI*f/fs) << " dB" << std::endl;
+    }
+    // stated in EqualizerDesign.h: 5.3 dB at 22 kHz (analog 3.75 dB)
+    double matched22k = magnitudedB(bMatched, aMatched, 2.0*M_PI*22000.0/fs);
+    bool ok = std::abs(matched22k - 5.34) < 0.05;
+    nrOfFailures += ok ? 0 : 1;
+    std::cout << (ok ? "ok    " : "FAILED") << " matched at 22 kHz = " << matched22k << " dB (5.34 dB)" << std::endl;
+
+    std::cout << "design time RBJ = " << designTime(designPeakEqualizer, fs) << " ns, matched = "
+              << designTime(designPeakEqualizerMatched, fs) << " ns" << std::endl;
+    return nrOfFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,158 @@
+// checks the binary preset bank (tools/PresetBank.h):
+// - round trip: write, open, names / categories / getPreset equal to the written presets, the last
+//   preset of a name wins, importToFolder writes every preset as XML file
+// - damaged files: every truncation, a wrong magic, an unknown version, a negative number of presets,
+//   a data offset behind the end of the file and an index entry that points outside the file must be
+//   rejected by open (a rejected bank is closed)
+#include <iostream>
+#include <vector>
+
+#include <JuceHeader.h>
+#include "../../tools/PresetBank.h"
+
+namespace
+{
+    const int c_headerSize = 20; // magic, version, number of presets, data offset
+
+    juce::ValueTree createPreset(const juce::String& name, const juce::String& category, double gain)
+    {
+        juce::ValueTree preset("PeakEqualizer");
+        preset.setProperty("presetname", name, nullptr);
+        preset.setProperty("category", category, nullptr);
+        juce::ValueTree parameter("PARAM");
+        parameter.setProperty("id", "Gain1", nullptr);
+        parameter.setProperty("value", gain, nullptr);
+        preset.appendChild(parameter, nullptr);
+        return preset;
+    }
+
+    int report(bool ok, const juce::String& name)
+    {
+        std::cout << (ok ? "ok    " : "FAILED") << " " << name << std::endl;
+        return ok ? 0 : 1;
+    }
+
+    // writes data as bank file, true if open accepts it (or leaves presets of a rejected file)
+    bool isAccepted(const juce::File& file, const juce::MemoryBlock& data, PresetBank& bank)
+    {
+        file.replaceWithData(data.getData(), data.getSize());
+        bool isOpen = bank.open(file);
+        return isOpen || bank.isOpen() || bank.getNrOfPresets() != 0;
+    }
+
+    void writeInt(juce::MemoryBlock& data, size_t position, int value)
+    {
+        juce::MemoryOutputStream stream;
+        stream.writeInt(value);
+        data.copyFrom(stream.getData(), static_cast<int>(position), stream.getDataSize());
+    }
+
+    void writeInt64(juce::MemoryBlock& data, size_t position, juce::int64 value)
+    {
+        juce::MemoryOutputStream stream;
+        stream.writeInt64(value);
+        data.copyFrom(stream.getData(), static_cast<int>(position), stream.getDataSize());
+    }
+}
+
+int main()
+{
+    auto folder = juce::File::getSpecialLocation(juce::File::tempDirectory).getNonexistentChildFile("PresetBankTester", "");
+    folder.createDirectory();
+    auto bankFile = folder.getChildFile("presets.bank");
+    auto damagedFile = folder.getChildFile("damaged.bank");
+    int nrOfFailures = 0;
+
+    // round trip
+    std::vector<juce::ValueTree> presets {createPreset("Vocal", "Voice", 3.0), createPreset("Bass", "Instrument", -6.0),
+        createPreset("Vocal", "Voice", 4.5), createPreset(juce::String::fromUTF8("Br\xc3\xbc" "cke"), "Instrument", 1.0)};
+    nrOfFailures += report(PresetBank::write(bankFile, presets), "write");
+    PresetBank bank;
+    bool isOpen = bank.open(bankFile);
+    nrOfFailures += report(isOpen && bank.getNrOfPresets() == 3, "open: one preset per name");
+    if (isOpen && bank.getNrOfPresets() == 3)
+    {
+        // sorted by name, the last preset of a name is in the bank
+        const std::vector<juce::ValueTree> expected {presets[1], presets[3], presets[2]};
+        bool ok = true;
+        for (auto kk = 0; kk < 3; ++kk)
+        {
+            auto name = expected[kk].getProperty("presetname").toString();
+            ok = ok && bank.getName(kk) == name && bank.getCategory(kk) == expected[kk].getProperty("category").toString()
+                && bank.indexOf(name) == kk && bank.getPreset(kk).isEquivalentTo(expected[kk]);
+        }
+        nrOfFailures += report(ok, "getName, getCategory, indexOf, getPreset");
+        nrOfFailures += report(bank.indexOf("Missing") == -1 && !bank.getPreset(-1).isValid() && !bank.getPreset(3).isValid(),
+            "unknown name and index");
+    }
+    bank.close();
+
+    auto xmlFolder = folder.getChildFile("xml");
+    xmlFolder.createDirectory();
+    int nrOfImported = PresetBank::importToFolder(bankFile, xmlFolder);
+    auto xml = juce::XmlDocument::parse(xmlFolder.getChildFile("Vocal.xml"));
+    nrOfFailures += report(nrOfImported == 3 && xml != nullptr && juce::ValueTree::fromXml(*xml).isEquivalentTo(presets[2]), "importToFolder");
+
+    nrOfFailures += report(PresetBank::write(damagedFile, {}) && bank.open(damagedFile) && bank.getNrOfPresets() == 0, "empty bank");
+    // the mapped file is overwritten by the next tests
+    bank.close();
+
+    // damaged files
+    juce::MemoryBlock valid;
+    bankFile.loadFileAsData(valid);
+    bool ok = true;
+    for (size_t size = 0; size < valid.getSize(); ++size)
+    {
+        juce::MemoryBlock truncated(valid.getData(), size);
+        if (isAccepted(damagedFile, truncated, bank))
+        {
+            std::cout << "       truncated to " << size << " of " << valid.getSize() << " bytes is accepted" << std::endl;
+            ok = false;
+        }
+    }
+    nrOfFailures += report(ok, "truncated files");
+
+    auto damaged = valid;
+    damaged[0] = 'X';
+    nrOfFailures += report(!isAccepted(damagedFile, damaged, bank), "wrong magic");
+
+    damaged = valid;
+    writeInt(damaged, 4, PresetBank::c_version + 1);
+    nrOfFailures += report(!isAccepted(damagedFile, damaged, bank), "unknown version");
+
+    damaged = valid;
+    writeInt(damaged, 8, -1);
+    nrOfFailures += report(!isAccepted(damagedFile, damaged, bank), "negative number of presets");
+
+    damaged = valid;
+    writeInt(damaged, 8, 1000);
+    nrOfFailures += report(!isAccepted(damagedFile, damaged, bank), "more presets than index entries");
+
+    damaged = valid;
+    writeInt64(damaged, 12, static_cast<juce::int64>(valid.getSize()) + 1);
+    nrOfFailures += report(!isAccepted(damagedFile, damaged, bank), "data offset behind the end of the file");
+
+    // the offset of the first entry follows its name and category (null terminated)
+    PresetBank reference;
+    reference.open(bankFile);
+    size_t entryPosition = c_headerSize + reference.getName(0).getNumBytesAsUTF8() + 1 + reference.getCategory(0).getNumBytesAsUTF8() + 1;
+    reference.close();
+    damaged = valid;
+    writeInt64(damaged, entryPosition, static_cast<juce::int64>(valid.getSize()));
+    nrOfFailures += report(!isAccepted(damagedFile, damaged, bank), "entry offset behind the end of the file");
+
+    damaged = valid;
+    writeInt64(damaged, entryPosition, -1);
+    nrOfFailures += report(!isAccepted(damagedFile, damaged, bank), "negative entry offset");
+
+    damaged = valid;
+    writeInt64(damaged, entryPosition + 8, static_cast<juce::int64>(valid.getSize()));
+    nrOfFailures += report(!isAccepted(damagedFile, damaged, bank), "entry size behind the end of the file");
+
+    // a rejected file does not keep the presets of the last bank
+    bank.open(bankFile);
+    nrOfFailures += report(!isAccepted(damagedFile, damaged, bank) && !bank.isOpen() && bank.getNrOfPresets() == 0, "rejected file closes the bank");
+
+    folder.deleteRecursively();
+    return nrOfFailures == 0 ? 0 : 1;
+}
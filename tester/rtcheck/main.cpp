@@ -0,0 +1,112 @@
+// checks that the RealtimeSafetyChecker reports allocations, locks and sleeps inside a realtime scope
+// (and nothing outside of it or in pure signal processing code)
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../../tools/RealtimeSafetyChecker.h"
+
+using jade::RealtimeSafetyChecker;
+
+// the allocations of the tests are stored here, otherwise the optimizer removes unused new/delete and malloc/free pairs
+void* volatile g_observedPointer = nullptr;
+
+int expect(const char* name, int expectedViolations)
+{
+    int violations = RealtimeSafetyChecker::getNrOfViolations();
+    RealtimeSafetyChecker::resetViolations();
+    bool ok = expectedViolations < 0 ? violations > 0 : violations == expectedViolations;
+    std::cout << (ok ? "ok    " : "FAILED") << " " << name << ": " << violations << " violations" << std::endl;
+    return ok ? 0 : 1;
+}
+
+int main()
+{
+    int nrOfFailures = 0;
+    std::vector<float> data(1024, 1.f);
+    std::mutex mutex;
+
+    // outside of the scope everything is allowed
+    {
+        auto pointer = std::make_unique<float[]>(100);
+        std::lock_guard<std::mutex> lock(mutex);
+        std::this_thread::sleep_for(std::chrono::microseconds(1));
+    }
+    nrOfFailures += expect("no realtime scope", 0);
+
+    {
+        JADE_REALTIME_SCOPE;
+        float sum = 0.f;
+        for (auto& value : data)
+        {
+            value *= 0.5f;
+            sum += value;
+        }
+        data[0] = sum;
+    }
+    nrOfFailures += expect("signal processing", 0);
+
+    {
+        JADE_REALTIME_SCOPE;
+        auto pointer = std::make_unique<float[]>(100);
+        g_observedPointer = pointer.get();
+    }
+    nrOfFailures += expect("new and delete", 2);
+
+    {
+        JADE_REALTIME_SCOPE;
+        data.resize(4096);
+    }
+    nrOfFailures += expect("vector growth", -1);
+
+    {
+        JADE_REALTIME_SCOPE;
+        g_observedPointer = std::malloc(16);
+        std::free(g_observedPointer);
+    }
+    nrOfFailures += expect("malloc and free", 2);
+
+    {
+        JADE_REALTIME_SCOPE;
+        std::lock_guard<std::mutex> lock(mutex);
+    }
+    nrOfFailures += expect("mutex lock", 1);
+
+    {
+        JADE_REALTIME_SCOPE;
+        std::this_thread::sleep_for(std::chrono::microseconds(1));
+    }
+    nrOfFailures += expect("sleep", 1);
+
+    // other threads are not affected by the scope of this thread: the worker is started before and
+    // joined after the scope, it allocates and sleeps while this thread is inside the scope
+    {
+        std::atomic<int> state{0}; // 0 waiting, 1 this thread is in the scope, 2 worker finished
+        std::thread worker([&state]()
+        {
+            while (state.load() != 1)
+                std::this_thread::yield();
+            std::vector<int> values(1000, 1);
+            g_observedPointer = values.data();
+            std::this_thread::sleep_for(std::chrono::microseconds(1));
+            state = 2;
+        });
+        {
+            JADE_REALTIME_SCOPE;
+            state = 1;
+            while (state.load() != 2)
+            {
+            }
+        }
+        worker.join();
+    }
+    nrOfFailures += expect("other thread", 0);
+
+    std::cout << (nrOfFailures == 0 ? "all checks passed" : "some checks failed") << std::endl;
+    return nrOfFailures == 0 ? 0 : 1;
+}
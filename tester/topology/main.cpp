@@ -0,0 +1,183 @@
+// compares the Direct Form I biquad (tools/MultiChannelBiquad) and the TPT state variable filter
+// (tools/MultiChannelSVF) for one peak band: time per sample and noise floor of the float version
+// (error against the double version of the same topology), static and with per sample modulation.
+// The loops are the scalar kernels of both classes without JUCE.
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+    #endif
+    #define TOPOLOGY_HAS_TSC 1
+#endif
+
+#include "../../EqualizerDesign.h"
+
+const double c_fs = 48000.0;
+const int c_blockSize = 48; // 1 ms synchron blocks, as in the plugin
+const int c_nrOfBlocks = 1000;
+
+// center frequency of the modulated case, sweeps +-2 octaves around f0 with 5 Hz (below fs/2)
+double modulatedF0(double f0, int block)
+{
+    return std::min(0.45 * c_fs, f0 * pow(2.0, 2.0 * sin(2.0 * M_PI * 5.0 * block * c_blockSize / c_fs)));
+}
+
+template <typename FloatType>
+struct DirectFormI
+{
+    FloatType b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+    FloatType x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+
+    void design(double f0, double Q, double gain, std::vector<double>& b, std::vector<double>& a)
+    {
+        designPeakEqualizer(b, a, f0, Q, gain, c_fs);
+    }
+    // coefficients ramp from the current to the new design over the block
+    void process(FloatType* data, int numSamples, const std::vector<double>& b, const std::vector<double>& a, bool ramp)
+    {
+        FloatType scale = FloatType(1) / numSamples;
+        FloatType db0 = ramp ? (FloatType(b[0]) - b0) * scale : 0;
+        FloatType db1 = ramp ? (FloatType(b[1]) - b1) * scale : 0;
+        FloatType db2 = ramp ? (FloatType(b[2]) - b2) * scale : 0;
+        FloatType da1 = ramp ? (FloatType(a[1]) - a1) * scale : 0;
+        FloatType da2 = ramp ? (FloatType(a[2]) - a2) * scale : 0;
+        if (!ramp)
+        {
+            b0 = FloatType(b[0]); b1 = FloatType(b[1]); b2 = FloatType(b[2]);
+            a1 = FloatType(a[1]); a2 = FloatType(a[2]);
+        }
+        for (auto sample = 0; sample < numSamples; ++sample)
+        {
+            if (ramp)
+            {
+                b0 += db0; b1 += db1; b2 += db2; a1 += da1; a2 += da2;
+            }
+            FloatType x = data[sample];
+            FloatType y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            data[sample] = y;
+        }
+    }
+};
+
+template <typename FloatType>
+struct StateVariable
+{
+    FloatType g = FloatType(0.1), k = 1, m1 = 0;
+    FloatType s1 = 0, s2 = 0;
+
+    void design(double f0, double Q, double gain, std::vector<double>& b, std::vector<double>& a)
+    {
+        // (g, k, m1) in b
+        a.resize(3);
+        b.resize(3);
+        designPeakEqualizerSVF(b[0], b[1], b[2], f0, Q, gain, c_fs);
+    }
+    void process(FloatType* data, int numSamples, const std::vector<double>& b, const std::vector<double>&, bool ramp)
+    {
+        FloatType scale = FloatType(1) / numSamples;
+        FloatType dg = ramp ? (FloatType(b[0]) - g) * scale : 0;
+        FloatType dk = ramp ? (FloatType(b[1]) - k) * scale : 0;
+        FloatType dm1 = ramp ? (FloatType(b[2]) - m1) * scale : 0;
+        if (!ramp)
+        {
+            g = FloatType(b[0]); k = FloatType(b[1]); m1 = FloatType(b[2]);
+        }
+        FloatType a1 = FloatType(1) / (FloatType(1) + g * (g + k));
+        FloatType a2 = g * a1;
+        FloatType a3 = g * a2;
+        for (auto sample = 0; sample < numSamples; ++sample)
+        {
+            if (ramp)
+            {
+                g += dg; k += dk; m1 += dm1;
+                a1 = FloatType(1) / (FloatType(1) + g * (g + k));
+                a2 = g * a1;
+                a3 = g * a2;
+            }
+            FloatType x = data[sample];
+            FloatType v3 = x - s2;
+            FloatType v1 = a1 * s1 + a2 * v3;
+            FloatType v2 = s2 + a2 * s1 + a3 * v3;
+            s1 = FloatType(2) * v1 - s1;
+            s2 = FloatType(2) * v2 - s2;
+            data[sample] = x + m1 * v1;
+        }
+    }
+};
+
+template <template <typename> class Topology>
+void measure(const char* name, const std::vector<double>& input, double f0, bool modulate)
+{
+    const double Q = 2.0;
+    const double gain = 12.0;
+    Topology<float> filter;
+    Topology<double> reference;
+    std::vector<float> data(input.begin(), input.end());
+    std::vector<double> referenceData(input);
+
+    // the design is not part of the measured time
+    std::vector<std::vector<double>> bList(c_nrOfBlocks), aList(c_nrOfBlocks);
+    for (auto block = 0; block < c_nrOfBlocks; ++block)
+        filter.design(modulate ? modulatedF0(f0, block) : f0, Q, gain, bList[block], aList[block]);
+
+    auto start = std::chrono::steady_clock::now();
+#if TOPOLOGY_HAS_TSC
+    auto startCycles = __rdtsc();
+#endif
+    for (auto block = 0; block < c_nrOfBlocks; ++block)
+        filter.process(data.data() + block * c_blockSize, c_blockSize, bList[block], aList[block], modulate && block > 0);
+#if TOPOLOGY_HAS_TSC
+    auto cycles = __rdtsc() - startCycles;
+#endif
+    auto time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (auto block = 0; block < c_nrOfBlocks; ++block)
+        reference.process(referenceData.data() + block * c_blockSize, c_blockSize, bList[block], aList[block], modulate && block > 0);
+
+    double signalPower = 0.0;
+    double noisePower = 0.0;
+    for (size_t kk = 0; kk < referenceData.size(); ++kk)
+    {
+        signalPower += referenceData[kk] * referenceData[kk];
+        noisePower += (referenceData[kk] - data[kk]) * (referenceData[kk] - data[kk]);
+    }
+    int nrOfSamples = c_nrOfBlocks * c_blockSize;
+    std::cout << name << (modulate ? " modulated" : " static   ") << " f0 = " << f0 << " Hz: "
+              << 1e9 * time / nrOfSamples << " ns/sample, ";
+#if TOPOLOGY_HAS_TSC
+    std::cout << double(cycles) / nrOfSamples << " cycles/sample, ";
+#endif
+    std::cout << "noise floor = " << 10.0 * log10(noisePower / signalPower + 1e-30) << " dB" << std::endl;
+}
+
+int main()
+{
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<double> distribution(-0.5, 0.5);
+    std::vector<double> input(c_nrOfBlocks * c_blockSize);
+    for (auto& value : input)
+        value = distribution(generator);
+
+    // the Direct Form I noise grows towards low center frequencies (poles close to z = 1)
+    for (auto f0 : {30.0, 100.0, 1000.0, 10000.0})
+    {
+        for (auto modulate : {false, true})
+        {
+            measure<DirectFormI>("DF-I", input, f0, modulate);
+            measure<StateVariable>("SVF ", input, f0, modulate);
+        }
+    }
+    return 0;
+}
@@ -6,9 +6,13 @@
     It can transform the parameter value to a different representation.
     Version 1.0 
     Version 1.1: changed variable names to be more descriptive
+    Version 1.2: transformer as switch instead of std::function (no indirect call, no allocation, copyable)
     License: MIT
 */
 #pragma once
+#include <atomic>
+#include <cmath>
+#include <limits>
 #include <vector>
 
 namespace jade
@@ -33,7 +37,7 @@ public:
         if (*m_param != m_ParamOld)
         {
             m_ParamOld = *m_param;
-            m_transformedParam =  m_transformParamFunc();
+            m_transformedParam = transform();
         }
         return m_transformedParam;
     };
@@ -41,7 +45,7 @@ public:
         if (*m_param != m_ParamOld)
         {
             m_ParamOld = *m_param;
-            m_transformedParam =  m_transformParamFunc();
+            m_transformedParam = transform();
             param = m_transformedParam;
             return true;
         }
@@ -50,39 +54,33 @@ public:
     };
     void changeTransformer(transformerFunc tf)
     {
-        switch (tf)
+        m_transformer = tf;
+    }
+
+private:
+    T transform() const
+    {
+        switch (m_transformer)
         {
-            case transformerFunc::notransform:
-                m_transformParamFunc = [this](){return m_ParamOld;};
-                break;
             case transformerFunc::db2gaintransform:
-                m_transformParamFunc = [this](){return pow(10.0,m_ParamOld/20.0);};
-                break;
+                return static_cast<T>(pow(10.0,m_ParamOld/20.0));
             case transformerFunc::db2powtransform:
-                m_transformParamFunc = [this](){return pow(10.0,m_ParamOld/10.0);};
-                break;
+                return static_cast<T>(pow(10.0,m_ParamOld/10.0));
             case transformerFunc::sqrttransform:
-                m_transformParamFunc = [this](){return sqrt(m_ParamOld);};
-                break;
+                return static_cast<T>(sqrt(m_ParamOld));
             case transformerFunc::exptransform:
-                m_transformParamFunc = [this](){return exp(m_ParamOld);};
-                break;
-
+                return static_cast<T>(exp(m_ParamOld));
+            case transformerFunc::notransform:
             default:
-                m_transformParamFunc = [this](){return m_ParamOld;};
-                break;
-
+                return m_ParamOld;
         }
-            
-        
     }
 
-private:
     std::atomic<T>* m_param = nullptr; 
     T m_ParamOld = std::numeric_limits<T>::min(); //smallest possible number, will change in the first block
     T m_transformedParam = std::numeric_limits<T>::min(); //smallest possible number, will change in the first block
 
-    std::function<T(void)> m_transformParamFunc;
+    transformerFunc m_transformer = transformerFunc::notransform;
 
 };
 }
\ No newline at end of file
@@ -0,0 +1,197 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <algorithm>
+#include "FrequencyResponse.h"
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define FREQRESPONSE_USE_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define FREQRESPONSE_USE_SSE 1
+#endif
+
+namespace
+{
+#if FREQRESPONSE_USE_AVX
+    constexpr int W = 8;
+    using Vec = __m256;
+    inline Vec vset1(float v) { return _mm256_set1_ps(v); }
+    inline Vec vload(const float* p) { return _mm256_loadu_ps(p); }
+    inline void vstore(float* p, Vec v) { _mm256_storeu_ps(p, v); }
+    inline Vec vmul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+    inline Vec vadd(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+    inline Vec vsub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+    inline Vec vdiv(Vec a, Vec b) { return _mm256_div_ps(a, b); }
+#elif FREQRESPONSE_USE_SSE
+    constexpr int W = 4;
+    using Vec = __m128;
+    inline Vec vset1(float v) { return _mm_set1_ps(v); }
+    inline Vec vload(const float* p) { return _mm_loadu_ps(p); }
+    inline void vstore(float* p, Vec v) { _mm_storeu_ps(p, v); }
+    inline Vec vmul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+    inline Vec vadd(Vec a, Vec b) { return _mm_add_ps(a, b); }
+    inline Vec vsub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+    inline Vec vdiv(Vec a, Vec b) { return _mm_div_ps(a, b); }
+#else
+    // plain C++ fallback (e.g. ARM), the loops are simple enough for the auto-vectorizer
+    constexpr int W = 4;
+    struct Vec { float v[W]; };
+    inline Vec vset1(float v) { Vec r; for (auto l = 0; l < W; ++l) r.v[l] = v; return r; }
+    inline Vec vload(const float* p) { Vec r; for (auto l = 0; l < W; ++l) r.v[l] = p[l]; return r; }
+    inline void vstore(float* p, Vec v) { for (auto l = 0; l < W; ++l) p[l] = v.v[l]; }
+    inline Vec vmul(Vec a, Vec b) { for (auto l = 0; l < W; ++l) a.v[l] *= b.v[l]; return a; }
+    inline Vec vadd(Vec a, Vec b) { for (auto l = 0; l < W; ++l) a.v[l] += b.v[l]; return a; }
+    inline Vec vsub(Vec a, Vec b) { for (auto l = 0; l < W; ++l) a.v[l] -= b.v[l]; return a; }
+    inline Vec vdiv(Vec a, Vec b) { for (auto l = 0; l < W; ++l) a.v[l] /= b.v[l]; return a; }
+#endif
+}
+
+FrequencyResponse::FrequencyResponse()
+:m_nrOfPoints(0), m_nrOfPaddedPoints(0), m_nrOfSections(0), m_sampleRate(0.0), m_cascadeChanged(false)
+{
+}
+
+void FrequencyResponse::prepare(int nrOfPoints, double minFreq, double maxFreq, int nrOfSections)
+{
+    m_nrOfPoints = nrOfPoints;
+    m_nrOfPaddedPoints = (nrOfPoints + W - 1) / W * W;
+    m_nrOfSections = nrOfSections;
+    m_sampleRate = 0.0;
+
+    m_frequencies.resize(nrOfPoints);
+    for (auto kk = 0; kk < nrOfPoints; ++kk)
+        m_frequencies[kk] = minFreq * pow(maxFreq / minFreq, nrOfPoints > 1 ? static_cast<double>(kk) / (nrOfPoints - 1) : 0.0);
+    m_uReal.assign(m_nrOfPaddedPoints, 0.f);
+    m_uImag.assign(m_nrOfPaddedPoints, 0.f);
+    m_u2Real.assign(m_nrOfPaddedPoints, 0.f);
+    m_u2Imag.assign(m_nrOfPaddedPoints, 0.f);
+
+    m_coefficients.assign(nrOfSections, Coefficients());
+    m_isActive.assign(nrOfSections, 0);
+    m_isChanged.assign(nrOfSections, 1);
+    m_cascadeChanged = true;
+    m_sectionReal.assign(nrOfSections * m_nrOfPaddedPoints, 1.f);
+    m_sectionImag.assign(nrOfSections * m_nrOfPaddedPoints, 0.f);
+    m_real.assign(m_nrOfPaddedPoints, 1.f);
+    m_imag.assign(m_nrOfPaddedPoints, 0.f);
+    m_magnitude_dB.assign(nrOfPoints, 0.f);
+    m_phase.assign(nrOfPoints, 0.f);
+}
+
+void FrequencyResponse::setSampleRate(double sampleRate)
+{
+    if (sampleRate == m_sampleRate)
+        return;
+    m_sampleRate = sampleRate;
+    for (auto kk = 0; kk < m_nrOfPoints; ++kk)
+    {
+        // u = 1 - e^-jw, the real part 1 - cos(w) without cancellation
+        double w = 2.0 * M_PI * m_frequencies[kk] / sampleRate;
+        double uReal = 2.0 * sin(0.5 * w) * sin(0.5 * w);
+        double uImag = sin(w);
+        m_uReal[kk] = static_cast<float>(uReal);
+        m_uImag[kk] = static_cast<float>(uImag);
+        m_u2Real[kk] = static_cast<float>(uReal * uReal - uImag * uImag);
+        m_u2Imag[kk] = static_cast<float>(2.0 * uReal * uImag);
+    }
+    std::fill(m_isChanged.begin(), m_isChanged.end(), 1);
+}
+
+bool FrequencyResponse::setCoefficients(int section, const std::vector<double>& b, const std::vector<double>& a)
+{
+    // b0 + b1 z^-1 + b2 z^-2 = (b0 + b1 + b2) - (b1 + 2 b2) u + b2 u^2 with u = 1 - z^-1,
+    // the sums are small for low frequency designs and keep their precision in double
+    Coefficients coefficients;
+    coefficients.n0 = (b[0] + b[1] + b[2]) / a[0];
+    coefficients.n1 = -(b[1] + 2.0 * b[2]) / a[0];
+    coefficients.n2 = b[2] / a[0];
+    coefficients.d0 = (a[0] + a[1] + a[2]) / a[0];
+    coefficients.d1 = -(a[1] + 2.0 * a[2]) / a[0];
+    coefficients.d2 = a[2] / a[0];
+    auto& old = m_coefficients[section];
+    if (coefficients.n0 == old.n0 && coefficients.n1 == old.n1 && coefficients.n2 == old.n2
+        && coefficients.d0 == old.d0 && coefficients.d1 == old.d1 && coefficients.d2 == old.d2)
+        return false;
+    old = coefficients;
+    m_isChanged[section] = 1;
+    return true;
+}
+
+void FrequencyResponse::setSectionActive(int section, bool isActive)
+{
+    if ((m_isActive[section] != 0) == isActive)
+        return;
+    m_isActive[section] = isActive ? 1 : 0;
+    m_cascadeChanged = true;
+}
+
+void FrequencyResponse::evaluateSection(int section)
+{
+    // N = n0 + n1 u + n2 u^2, D = d0 + d1 u + d2 u^2, H = N conj(D) / |D|^2
+    const auto& c = m_coefficients[section];
+    Vec n0 = vset1(static_cast<float>(c.n0));
+    Vec n1 = vset1(static_cast<float>(c.n1));
+    Vec n2 = vset1(static_cast<float>(c.n2));
+    Vec d0 = vset1(static_cast<float>(c.d0));
+    Vec d1 = vset1(static_cast<float>(c.d1));
+    Vec d2 = vset1(static_cast<float>(c.d2));
+    float* real = &m_sectionReal[section * m_nrOfPaddedPoints];
+    float* imag = &m_sectionImag[section * m_nrOfPaddedPoints];
+    for (auto kk = 0; kk < m_nrOfPaddedPoints; kk += W)
+    {
+        Vec uReal = vload(&m_uReal[kk]);
+        Vec uImag = vload(&m_uImag[kk]);
+        Vec u2Real = vload(&m_u2Real[kk]);
+        Vec u2Imag = vload(&m_u2Imag[kk]);
+        Vec numReal = vadd(n0, vadd(vmul(n1, uReal), vmul(n2, u2Real)));
+        Vec numImag = vadd(vmul(n1, uImag), vmul(n2, u2Imag));
+        Vec denReal = vadd(d0, vadd(vmul(d1, uReal), vmul(d2, u2Real)));
+        Vec denImag = vadd(vmul(d1, uImag), vmul(d2, u2Imag));
+        Vec denPower = vadd(vmul(denReal, denReal), vmul(denImag, denImag));
+        vstore(real + kk, vdiv(vadd(vmul(numReal, denReal), vmul(numImag, denImag)), denPower));
+        vstore(imag + kk, vdiv(vsub(vmul(numImag, denReal), vmul(numReal, denImag)), denPower));
+    }
+}
+
+bool FrequencyResponse::update()
+{
+    for (auto section = 0; section < m_nrOfSections; ++section)
+    {
+        if (!m_isChanged[section])
+            continue;
+        m_isChanged[section] = 0;
+        evaluateSection(section);
+        if (m_isActive[section])
+            m_cascadeChanged = true;
+    }
+    if (!m_cascadeChanged)
+        return false;
+    m_cascadeChanged = false;
+
+    // complex product of the active sections
+    std::fill(m_real.begin(), m_real.end(), 1.f);
+    std::fill(m_imag.begin(), m_imag.end(), 0.f);
+    for (auto section = 0; section < m_nrOfSections; ++section)
+    {
+        if (!m_isActive[section])
+            continue;
+        const float* sectionReal = &m_sectionReal[section * m_nrOfPaddedPoints];
+        const float* sectionImag = &m_sectionImag[section * m_nrOfPaddedPoints];
+        for (auto kk = 0; kk < m_nrOfPaddedPoints; kk += W)
+        {
+            Vec real = vload(&m_real[kk]);
+            Vec imag = vload(&m_imag[kk]);
+            Vec hReal = vload(sectionReal + kk);
+            Vec hImag = vload(sectionImag + kk);
+            vstore(&m_real[kk], vsub(vmul(real, hReal), vmul(imag, hImag)));
+            vstore(&m_imag[kk], vadd(vmul(real, hImag), vmul(imag, hReal)));
+        }
+    }
+    for (auto kk = 0; kk < m_nrOfPoints; ++kk)
+    {
+        m_magnitude_dB[kk] = 10.f * log10f(m_real[kk] * m_real[kk] + m_imag[kk] * m_imag[kk] + 1e-30f);
+        m_phase[kk] = atan2f(m_imag[kk], m_real[kk]);
+    }
+    return true;
+}
@@ -0,0 +1,132 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include "LinearPhaseFilter.h"
+
+template <typename FloatType>
+LinearPhaseFilter<FloatType>::LinearPhaseFilter()
+:m_fftSize(0), m_nrOfBins(0), m_nrOfSections(0), m_gainChanged(false)
+{
+}
+
+template <typename FloatType>
+void LinearPhaseFilter<FloatType>::prepare(int maxChannels, int fftSize, int nrOfSections)
+{
+    jassert(juce::isPowerOfTwo(fftSize) && fftSize >= 64);
+    m_fftSize = fftSize;
+    m_nrOfBins = fftSize / 2 + 1;
+    m_nrOfSections = nrOfSections;
+    m_fft = std::make_unique<juce::dsp::FFT>(static_cast<int>(log2(fftSize) + 0.5));
+
+    m_cosw.resize(m_nrOfBins);
+    m_cos2w.resize(m_nrOfBins);
+    for (auto kk = 0; kk < m_nrOfBins; ++kk)
+    {
+        double w = 2.0 * M_PI * kk / fftSize;
+        m_cosw[kk] = cos(w);
+        m_cos2w[kk] = cos(2.0 * w);
+    }
+    m_sectionPower.assign(nrOfSections * m_nrOfBins, 1.0);
+    m_isActive.assign(nrOfSections, 0);
+    m_spectralGain.assign(m_nrOfBins, 1.f);
+    m_gainChanged = false;
+
+    // Tukey window: flat up to 3/4 of fftSize/4, then a cosine taper to 0 at fftSize/4
+    int kernelHalfLength = fftSize / 4;
+    int flatLength = 3 * kernelHalfLength / 4;
+    m_kernelWindow.resize(kernelHalfLength + 1);
+    for (auto kk = 0; kk <= kernelHalfLength; ++kk)
+    {
+        if (kk < flatLength)
+            m_kernelWindow[kk] = 1.f;
+        else
+            m_kernelWindow[kk] = static_cast<float>(0.5 * (1.0 + cos(M_PI * (kk - flatLength) / (kernelHalfLength - flatLength))));
+    }
+    m_work.assign(2 * fftSize, 0.f);
+
+    // Hann over the middle half of the frame (50% overlap of the windows, hop fftSize/4), no synthesis window:
+    // the filtered frame (fftSize/2 + kernel length) fits into fftSize, the overlap-add is an exact linear convolution
+    this->prepareWOLAprocessing(maxChannels, fftSize, 4, WOLA<FloatType>::WinType::ZeroPaddedHann, WOLA<FloatType>::WinType::Rect);
+}
+
+template <typename FloatType>
+void LinearPhaseFilter<FloatType>::setCoefficients(int section, const std::vector<double>& b, const std::vector<double>& a)
+{
+    // |B(w)|^2 = b0^2 + b1^2 + b2^2 + 2 (b0 b1 + b1 b2) cos(w) + 2 b0 b2 cos(2w), same for A with (1,a1,a2)
+    double b0 = b[0] * b[0] + b[1] * b[1] + b[2] * b[2];
+    double b1 = 2.0 * (b[0] * b[1] + b[1] * b[2]);
+    double b2 = 2.0 * b[0] * b[2];
+    double a0 = 1.0 + a[1] * a[1] + a[2] * a[2];
+    double a1 = 2.0 * (a[1] + a[1] * a[2]);
+    double a2 = 2.0 * a[2];
+    double* power = &m_sectionPower[section * m_nrOfBins];
+    for (auto kk = 0; kk < m_nrOfBins; ++kk)
+        power[kk] = (b0 + b1 * m_cosw[kk] + b2 * m_cos2w[kk]) / (a0 + a1 * m_cosw[kk] + a2 * m_cos2w[kk]);
+    if (m_isActive[section])
+        m_gainChanged = true;
+}
+
+template <typename FloatType>
+void LinearPhaseFilter<FloatType>::setSectionActive(int section, bool isActive)
+{
+    if ((m_isActive[section] != 0) == isActive)
+        return;
+    m_isActive[section] = isActive ? 1 : 0;
+    m_gainChanged = true;
+}
+
+template <typename FloatType>
+void LinearPhaseFilter<FloatType>::updateSpectralGain()
+{
+    // zero phase spectrum: magnitude as real part
+    for (auto kk = 0; kk < m_nrOfBins; ++kk)
+    {
+        double power = 1.0;
+        for (auto section = 0; section < m_nrOfSections; ++section)
+            if (m_isActive[section])
+                power *= m_sectionPower[section * m_nrOfBins + kk];
+        m_work[2 * kk] = static_cast<float>(sqrt(power));
+        m_work[2 * kk + 1] = 0.f;
+    }
+    // impulse response (symmetric around tap 0), tapered to -fftSize/4 ... fftSize/4
+    m_fft->performRealOnlyInverseTransform(m_work.data());
+    int kernelHalfLength = m_fftSize / 4;
+    for (auto kk = 1; kk < kernelHalfLength; ++kk)
+    {
+        m_work[kk] *= m_kernelWindow[kk];
+        m_work[m_fftSize - kk] *= m_kernelWindow[kk];
+    }
+    std::fill(m_work.begin() + kernelHalfLength, m_work.begin() + m_fftSize - kernelHalfLength + 1, 0.f);
+    m_fft->performRealOnlyForwardTransform(m_work.data(), true);
+    for (auto kk = 0; kk < m_nrOfBins; ++kk)
+        m_spectralGain[kk] = m_work[2 * kk];
+}
+
+template <typename FloatType>
+int LinearPhaseFilter<FloatType>::processWOLA(juce::AudioBuffer<FloatType>& block, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    if (m_gainChanged)
+    {
+        updateSpectralGain();
+        m_gainChanged = false;
+    }
+    for (auto cc = 0; cc < block.getNumChannels(); ++cc)
+    {
+        FloatType* data = block.getWritePointer(cc);
+        for (auto kk = 0; kk < m_fftSize; ++kk)
+            m_work[kk] = static_cast<float>(data[kk]);
+        m_fft->performRealOnlyForwardTransform(m_work.data(), true);
+        for (auto kk = 0; kk < m_nrOfBins; ++kk)
+        {
+            m_work[2 * kk] *= m_spectralGain[kk];
+            m_work[2 * kk + 1] *= m_spectralGain[kk];
+        }
+        m_fft->performRealOnlyInverseTransform(m_work.data());
+        for (auto kk = 0; kk < m_fftSize; ++kk)
+            data[kk] = static_cast<FloatType>(m_work[kk]);
+    }
+    return 0;
+}
+
+template class LinearPhaseFilter<float>;
+template class LinearPhaseFilter<double>;
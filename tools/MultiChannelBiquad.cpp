@@ -0,0 +1,466 @@
+#include "MultiChannelBiquad.h"
+
+#if MCBIQUAD_USE_AVX || MCBIQUAD_USE_SSE
+    #include <immintrin.h>
+#endif
+
+namespace
+{
+    constexpr int W = MultiChannelBiquad<float>::c_laneWidth;
+
+#if MCBIQUAD_USE_AVX
+    using Vec = __m256;
+    inline Vec vset1(float v) { return _mm256_set1_ps(v); }
+    inline Vec vload(const float* p) { return _mm256_load_ps(p); }
+    inline Vec vloadu(const float* p) { return _mm256_loadu_ps(p); }
+    inline void vstore(float* p, Vec v) { _mm256_store_ps(p, v); }
+    inline void vstoreu(float* p, Vec v) { _mm256_storeu_ps(p, v); }
+    inline Vec vmul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+    inline Vec vadd(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+    inline Vec vsub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+    // rows[k] holds sample k of all lanes afterwards (and vice versa)
+    inline void transpose(Vec* r)
+    {
+        Vec t0 = _mm256_unpacklo_ps(r[0], r[1]);
+        Vec t1 = _mm256_unpackhi_ps(r[0], r[1]);
+        Vec t2 = _mm256_unpacklo_ps(r[2], r[3]);
+        Vec t3 = _mm256_unpackhi_ps(r[2], r[3]);
+        Vec t4 = _mm256_unpacklo_ps(r[4], r[5]);
+        Vec t5 = _mm256_unpackhi_ps(r[4], r[5]);
+        Vec t6 = _mm256_unpacklo_ps(r[6], r[7]);
+        Vec t7 = _mm256_unpackhi_ps(r[6], r[7]);
+        Vec s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+        Vec s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+        Vec s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        Vec s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+        Vec s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+        Vec s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+        Vec s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+        Vec s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+        r[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+        r[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+        r[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+        r[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+        r[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+        r[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+        r[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+        r[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+    }
+#elif MCBIQUAD_USE_SSE
+    using Vec = __m128;
+    inline Vec vset1(float v) { return _mm_set1_ps(v); }
+    inline Vec vload(const float* p) { return _mm_load_ps(p); }
+    inline Vec vloadu(const float* p) { return _mm_loadu_ps(p); }
+    inline void vstore(float* p, Vec v) { _mm_store_ps(p, v); }
+    inline void vstoreu(float* p, Vec v) { _mm_storeu_ps(p, v); }
+    inline Vec vmul(Vec a, Vec b) { return _mm_mul_ps(a, b); }
+    inline Vec vadd(Vec a, Vec b) { return _mm_add_ps(a, b); }
+    inline Vec vsub(Vec a, Vec b) { return _mm_sub_ps(a, b); }
+    inline void transpose(Vec* r)
+    {
+        _MM_TRANSPOSE4_PS(r[0], r[1], r[2], r[3]);
+    }
+#else
+    // plain C++ fallback (e.g. ARM), the loops are simple enough for the auto-vectorizer
+    struct Vec { float v[W]; };
+    inline Vec vset1(float v) { Vec r; for (auto l = 0; l < W; ++l) r.v[l] = v; return r; }
+    inline Vec vload(const float* p) { Vec r; for (auto l = 0; l < W; ++l) r.v[l] = p[l]; return r; }
+    inline Vec vloadu(const float* p) { return vload(p); }
+    inline void vstore(float* p, Vec v) { for (auto l = 0; l < W; ++l) p[l] = v.v[l]; }
+    inline void vstoreu(float* p, Vec v) { vstore(p, v); }
+    inline Vec vmul(Vec a, Vec b) { for (auto l = 0; l < W; ++l) a.v[l] *= b.v[l]; return a; }
+    inline Vec vadd(Vec a, Vec b) { for (auto l = 0; l < W; ++l) a.v[l] += b.v[l]; return a; }
+    inline Vec vsub(Vec a, Vec b) { for (auto l = 0; l < W; ++l) a.v[l] -= b.v[l]; return a; }
+    inline void transpose(Vec* r)
+    {
+        for (auto kk = 0; kk < W; ++kk)
+            for (auto ll = kk + 1; ll < W; ++ll)
+                std::swap(r[kk].v[ll], r[ll].v[kk]);
+    }
+#endif
+}
+
+MultiChannelBiquad<float>::MultiChannelBiquad()
+:m_maxChannels(0),m_nrOfGroups(0)
+{
+    prepare(2);
+}
+
+void MultiChannelBiquad<float>::prepare(int maxChannels, int nrOfSections)
+{
+    m_maxChannels = maxChannels;
+    m_nrOfGroups = (maxChannels + W - 1) / W;
+    prepareSections(nrOfSections);
+    m_states.resize(m_nrOfGroups * m_nrOfSections);
+    m_inputHistory.resize(m_nrOfGroups);
+    if (m_nrOfSections == 1)
+        setSectionActive(0, true);
+
+    reset();
+}
+
+void MultiChannelBiquad<float>::reset()
+{
+    for (auto section = 0; section < m_nrOfSections; ++section)
+        resetSection(section);
+    for (auto& history : m_inputHistory)
+    {
+        for (auto l = 0; l < W; ++l)
+        {
+            history.x1[l] = 0.f;
+            history.x2[l] = 0.f;
+        }
+    }
+}
+
+void MultiChannelBiquad<float>::resetSection(int section)
+{
+    for (auto group = 0; group < m_nrOfGroups; ++group)
+    {
+        auto& state = m_states[group * m_nrOfSections + section];
+        for (auto l = 0; l < W; ++l)
+        {
+            state.x1[l] = 0.f;
+            state.x2[l] = 0.f;
+            state.y1[l] = 0.f;
+            state.y2[l] = 0.f;
+        }
+    }
+}
+
+void MultiChannelBiquad<float>::seedSection(int section)
+{
+    // the input of the section is the output of the previous active section (or the cascade input),
+    // an identity has the same output history
+    int previous = getPreviousActiveSection(section);
+    for (auto group = 0; group < m_nrOfGroups; ++group)
+    {
+        auto& state = m_states[group * m_nrOfSections + section];
+        for (auto l = 0; l < W; ++l)
+        {
+            if (previous >= 0)
+            {
+                auto& previousState = m_states[group * m_nrOfSections + previous];
+                state.x1[l] = previousState.y1[l];
+                state.x2[l] = previousState.y2[l];
+            }
+            else
+            {
+                state.x1[l] = m_inputHistory[group].x1[l];
+                state.x2[l] = m_inputHistory[group].x2[l];
+            }
+            state.y1[l] = state.x1[l];
+            state.y2[l] = state.x2[l];
+        }
+    }
+}
+
+void MultiChannelBiquad<float>::setSectionActive(int section, bool isActive)
+{
+    if (changeSectionActive(section, isActive))
+        seedSection(section);
+}
+
+void MultiChannelBiquad<float>::processBlock(juce::AudioBuffer<float>& data)
+{
+    prepareBlock(data.getNumSamples());
+    processChannels(data, 0, data.getNumChannels());
+    finishBlock();
+}
+
+void MultiChannelBiquad<float>::processChannels(juce::AudioBuffer<float>& data, int startChannel, int nrOfChannels)
+{
+    int endChannel = startChannel + nrOfChannels;
+    int numSamples = data.getNumSamples();
+    jassert(endChannel <= m_maxChannels && endChannel <= data.getNumChannels());
+    // channel ranges of different threads must not share a lane group
+    jassert(startChannel % W == 0);
+    auto channelData = data.getArrayOfWritePointers();
+
+    // the input history is needed to switch on sections without clicks (also if all are inactive)
+    for (auto cc = startChannel; cc < endChannel && numSamples > 0; ++cc)
+    {
+        auto& history = m_inputHistory[cc / W];
+        int lane = cc % W;
+        history.x2[lane] = numSamples > 1 ? channelData[cc][numSamples - 2] : history.x1[lane];
+        history.x1[lane] = channelData[cc][numSamples - 1];
+    }
+
+    if (m_activeSections.empty() || numSamples == 0)
+        return;
+
+    int group = startChannel / W;
+    for (auto cc = startChannel; cc < endChannel; cc += W, ++group)
+    {
+        int nrOfLanes = juce::jmin(W, endChannel - cc);
+        LaneGroupState* states = &m_states[group * m_nrOfSections];
+        if (nrOfLanes == W)
+            processFullGroup(channelData + cc, states, numSamples);
+        else
+            processPartialGroup(channelData + cc, nrOfLanes, states, numSamples);
+    }
+}
+
+void MultiChannelBiquad<float>::processFullGroup(float* const* channelData, LaneGroupState* states, int numSamples)
+{
+    // runs nrOfSamples vectors (one sample of all lanes each), starting at startSample, through one section
+    auto filterSection = [this, states](int section, Vec* rows, int nrOfSamples, int startSample)
+    {
+        auto& state = states[section];
+        Vec x1 = vload(state.x1);
+        Vec x2 = vload(state.x2);
+        Vec y1 = vload(state.y1);
+        Vec y2 = vload(state.y2);
+        auto step = [&](Vec x, Vec b0, Vec b1, Vec b2, Vec a1, Vec a2)
+        {
+            Vec y = vsub(vadd(vadd(vmul(b0, x), vmul(b1, x1)), vmul(b2, x2)),
+                         vadd(vmul(a1, y1), vmul(a2, y2)));
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            return y;
+        };
+        if (m_isRamping[section])
+        {
+            // coefficients of sample n are start + (n+1)*increment
+            Vec b0 = vset1(m_b0[section] + startSample * m_db0[section]);
+            Vec b1 = vset1(m_b1[section] + startSample * m_db1[section]);
+            Vec b2 = vset1(m_b2[section] + startSample * m_db2[section]);
+            Vec a1 = vset1(m_a1[section] + startSample * m_da1[section]);
+            Vec a2 = vset1(m_a2[section] + startSample * m_da2[section]);
+            const Vec db0 = vset1(m_db0[section]);
+            const Vec db1 = vset1(m_db1[section]);
+            const Vec db2 = vset1(m_db2[section]);
+            const Vec da1 = vset1(m_da1[section]);
+            const Vec da2 = vset1(m_da2[section]);
+            for (auto kk = 0; kk < nrOfSamples; ++kk)
+            {
+                b0 = vadd(b0, db0);
+                b1 = vadd(b1, db1);
+                b2 = vadd(b2, db2);
+                a1 = vadd(a1, da1);
+                a2 = vadd(a2, da2);
+                rows[kk] = step(rows[kk], b0, b1, b2, a1, a2);
+            }
+        }
+        else
+        {
+            const Vec b0 = vset1(m_b0[section]);
+            const Vec b1 = vset1(m_b1[section]);
+            const Vec b2 = vset1(m_b2[section]);
+            const Vec a1 = vset1(m_a1[section]);
+            const Vec a2 = vset1(m_a2[section]);
+            for (auto kk = 0; kk < nrOfSamples; ++kk)
+                rows[kk] = step(rows[kk], b0, b1, b2, a1, a2);
+        }
+        vstore(state.x1, x1);
+        vstore(state.x2, x2);
+        vstore(state.y1, y1);
+        vstore(state.y2, y2);
+    };
+
+    // W samples of W channels at once: load, transpose to one vector per sample,
+    // run through all active sections and transpose back
+    int sample = 0;
+    for (; sample + W <= numSamples; sample += W)
+    {
+        Vec rows[W];
+        for (auto l = 0; l < W; ++l)
+            rows[l] = vloadu(channelData[l] + sample);
+        transpose(rows);
+        for (auto section : m_activeSections)
+            filterSection(section, rows, W, sample);
+        transpose(rows);
+        for (auto l = 0; l < W; ++l)
+            vstoreu(channelData[l] + sample, rows[l]);
+    }
+    // remaining samples one by one
+    alignas(32) float lanes[W];
+    for (; sample < numSamples; ++sample)
+    {
+        for (auto l = 0; l < W; ++l)
+            lanes[l] = channelData[l][sample];
+        Vec row = vload(lanes);
+        for (auto section : m_activeSections)
+            filterSection(section, &row, 1, sample);
+        vstore(lanes, row);
+        for (auto l = 0; l < W; ++l)
+            channelData[l][sample] = lanes[l];
+    }
+}
+
+void MultiChannelBiquad<float>::processPartialGroup(float* const* channelData, int nrOfLanes, LaneGroupState* states, int numSamples)
+{
+    for (auto l = 0; l < nrOfLanes; ++l)
+    {
+        float* data = channelData[l];
+        for (auto section : m_activeSections)
+        {
+            auto& state = states[section];
+            float b0 = m_b0[section];
+            float b1 = m_b1[section];
+            float b2 = m_b2[section];
+            float a1 = m_a1[section];
+            float a2 = m_a2[section];
+            float x1 = state.x1[l];
+            float x2 = state.x2[l];
+            float y1 = state.y1[l];
+            float y2 = state.y2[l];
+            auto step = [&](float x)
+            {
+                float y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+                x2 = x1;
+                x1 = x;
+                y2 = y1;
+                y1 = y;
+                return y;
+            };
+            if (m_isRamping[section])
+            {
+                for (auto sample = 0; sample < numSamples; ++sample)
+                {
+                    b0 += m_db0[section];
+                    b1 += m_db1[section];
+                    b2 += m_db2[section];
+                    a1 += m_da1[section];
+                    a2 += m_da2[section];
+                    data[sample] = step(data[sample]);
+                }
+            }
+            else
+            {
+                for (auto sample = 0; sample < numSamples; ++sample)
+                    data[sample] = step(data[sample]);
+            }
+            state.x1[l] = x1;
+            state.x2[l] = x2;
+            state.y1[l] = y1;
+            state.y2[l] = y2;
+        }
+    }
+}
+
+template <typename FloatType>
+MultiChannelBiquad<FloatType>::MultiChannelBiquad()
+:m_maxChannels(0)
+{
+    prepare(2);
+}
+
+template <typename FloatType>
+void MultiChannelBiquad<FloatType>::prepare(int maxChannels, int nrOfSections)
+{
+    m_maxChannels = maxChannels;
+    this->prepareSections(nrOfSections);
+    m_states.resize(m_maxChannels * nrOfSections);
+    m_inputHistory.resize(m_maxChannels);
+    if (nrOfSections == 1)
+        setSectionActive(0, true);
+
+    reset();
+}
+
+template <typename FloatType>
+void MultiChannelBiquad<FloatType>::reset()
+{
+    for (auto& state : m_states)
+        state = {0, 0, 0, 0};
+    for (auto& history : m_inputHistory)
+        history = {0, 0, 0, 0};
+}
+
+template <typename FloatType>
+void MultiChannelBiquad<FloatType>::seedSection(int section)
+{
+    int previous = this->getPreviousActiveSection(section);
+    for (auto channel = 0; channel < m_maxChannels; ++channel)
+    {
+        auto& state = m_states[channel * this->m_nrOfSections + section];
+        if (previous >= 0)
+        {
+            auto& previousState = m_states[channel * this->m_nrOfSections + previous];
+            state.x1 = previousState.y1;
+            state.x2 = previousState.y2;
+        }
+        else
+        {
+            state.x1 = m_inputHistory[channel].x1;
+            state.x2 = m_inputHistory[channel].x2;
+        }
+        state.y1 = state.x1;
+        state.y2 = state.x2;
+    }
+}
+
+template <typename FloatType>
+void MultiChannelBiquad<FloatType>::setSectionActive(int section, bool isActive)
+{
+    if (this->changeSectionActive(section, isActive))
+        seedSection(section);
+}
+
+template <typename FloatType>
+void MultiChannelBiquad<FloatType>::processBlock(juce::AudioBuffer<FloatType>& data)
+{
+    this->prepareBlock(data.getNumSamples());
+    processChannels(data, 0, data.getNumChannels());
+    this->finishBlock();
+}
+
+template <typename FloatType>
+void MultiChannelBiquad<FloatType>::processChannels(juce::AudioBuffer<FloatType>& data, int startChannel, int nrOfChannels)
+{
+    int endChannel = startChannel + nrOfChannels;
+    int numSamples = data.getNumSamples();
+    jassert(endChannel <= m_maxChannels && endChannel <= data.getNumChannels());
+    for (auto channel = startChannel; channel < endChannel && numSamples > 0; ++channel)
+    {
+        const FloatType* channelData = data.getReadPointer(channel);
+        auto& history = m_inputHistory[channel];
+        history.x2 = numSamples > 1 ? channelData[numSamples - 2] : history.x1;
+        history.x1 = channelData[numSamples - 1];
+    }
+
+    for (auto channel = startChannel; channel < endChannel && numSamples > 0; ++channel)
+    {
+        FloatType* channelData = data.getWritePointer(channel);
+        for (auto section : this->m_activeSections)
+        {
+            auto& state = m_states[channel * this->m_nrOfSections + section];
+            FloatType b0 = this->m_b0[section];
+            FloatType b1 = this->m_b1[section];
+            FloatType b2 = this->m_b2[section];
+            FloatType a1 = this->m_a1[section];
+            FloatType a2 = this->m_a2[section];
+            auto step = [&](FloatType x)
+            {
+                FloatType y = b0 * x + b1 * state.x1 + b2 * state.x2 - a1 * state.y1 - a2 * state.y2;
+                state.x2 = state.x1;
+                state.x1 = x;
+                state.y2 = state.y1;
+                state.y1 = y;
+                return y;
+            };
+            if (this->m_isRamping[section])
+            {
+                for (auto sample = 0; sample < numSamples; ++sample)
+                {
+                    b0 += this->m_db0[section];
+                    b1 += this->m_db1[section];
+                    b2 += this->m_db2[section];
+                    a1 += this->m_da1[section];
+                    a2 += this->m_da2[section];
+                    channelData[sample] = step(channelData[sample]);
+                }
+            }
+            else
+            {
+                for (auto sample = 0; sample < numSamples; ++sample)
+                    channelData[sample] = step(channelData[sample]);
+            }
+        }
+    }
+}
+
+template class MultiChannelBiquad<double>;
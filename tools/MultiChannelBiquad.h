@@ -0,0 +1,343 @@
+/**
+ * @file MultiChannelBiquad.h
+ * @author J. Bitzer @ Jade HS, BSD Licence
+ * @brief cascade of Direct Form I biquads for many channels, vectorized across channels
+ * The float version is specialized: the channels are processed in lane groups of 4 (SSE, or plain C++ on other platforms)
+ * or 8 (AVX) channels. The states of all channels of one lane group are stored
+ * interleaved in one aligned struct, the coefficients of all sections are stored as
+ * structure of arrays and converted to float once per call of setCoefficients
+ * (typically once per synchron block).
+ * All active sections are applied in one pass over the data, inactive sections
+ * (e.g. bypassed or 0 dB bands) cost nothing. An inactive section behaves like an identity,
+ * therefore a section that becomes active starts with the states an identity would have
+ * (its output history equals its input history), switching on a section at or near
+ * unity gain is click-free.
+ * All other sample types (double) use a plain cascade per channel.
+ * Coefficients can either jump (setCoefficients) or ramp linearly sample by sample
+ * over the next processBlock call (setTargetCoefficients). A linear ramp between two
+ * stable biquads is stable, since the stability triangle of (a1,a2) is convex.
+ * Usage: prepare(maxChannels, nrOfSections), setCoefficients(section,b,a),
+ * setSectionActive(section,true), processBlock(buffer)
+ * For parallel processing processBlock can be split into prepareBlock(numSamples),
+ * processChannels(buffer, start, nr) for disjoint channel ranges (on any thread, for float
+ * start has to be a multiple of the lane width) and finishBlock().
+ * @version 1.5
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+// Version 1.0 single section
+// Version 1.1 cascade of sections with structure of arrays coefficients and active section list
+// Version 1.2 template for float and double, float keeps the vectorized kernel
+// Version 1.3 per sample coefficient ramps
+// Version 1.4 sections are activated with identity states instead of zero states
+// Version 1.5 processing of channel ranges (prepareBlock, processChannels, finishBlock)
+
+#pragma once
+#include <vector>
+#include <JuceHeader.h>
+
+#if defined(__AVX__)
+    #define MCBIQUAD_USE_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define MCBIQUAD_USE_SSE 1
+#endif
+
+/**
+ * @brief coefficients (structure of arrays) and active section list, common to all MultiChannelBiquad versions
+ *
+ */
+template <typename FloatType>
+class BiquadCascadeSections
+{
+public:
+    /**
+     * @brief converts the coefficients (b0,b1,b2) and (1,a1,a2) of one section to FloatType, a[0] is assumed to be 1
+     *
+     * @param section index of the section in the cascade
+     * @param b numerator coefficients
+     * @param a denominator coefficients
+     */
+    void setCoefficients(int section, const std::vector<double>& b, const std::vector<double>& a)
+    {
+        m_b0[section] = static_cast<FloatType>(b[0]);
+        m_b1[section] = static_cast<FloatType>(b[1]);
+        m_b2[section] = static_cast<FloatType>(b[2]);
+        m_a1[section] = static_cast<FloatType>(a[1]);
+        m_a2[section] = static_cast<FloatType>(a[2]);
+        m_isRamping[section] = 0;
+    }
+    /**
+     * @brief same as setCoefficients, but the coefficients ramp linearly from the current ones
+     * to the new ones over the next processBlock call (the last sample uses the new coefficients)
+     *
+     * @param section index of the section in the cascade
+     * @param b numerator coefficients
+     * @param a denominator coefficients
+     */
+    void setTargetCoefficients(int section, const std::vector<double>& b, const std::vector<double>& a)
+    {
+        m_b0Target[section] = static_cast<FloatType>(b[0]);
+        m_b1Target[section] = static_cast<FloatType>(b[1]);
+        m_b2Target[section] = static_cast<FloatType>(b[2]);
+        m_a1Target[section] = static_cast<FloatType>(a[1]);
+        m_a2Target[section] = static_cast<FloatType>(a[2]);
+        m_isRamping[section] = 1;
+        m_anyRamping = true;
+    }
+    /**
+     * @brief sets the coefficients of one section to an identity (b0 = 1), e.g. as start of a ramp
+     *
+     * @param section index of the section in the cascade
+     */
+    void setIdentity(int section)
+    {
+        m_b0[section] = FloatType(1);
+        m_b1[section] = FloatType(0);
+        m_b2[section] = FloatType(0);
+        m_a1[section] = FloatType(0);
+        m_a2[section] = FloatType(0);
+        m_isRamping[section] = 0;
+    }
+    bool isSectionActive(int section) const {return m_isActive[section] != 0;};
+    int getNrOfActiveSections() const {return static_cast<int>(m_activeSections.size());};
+    int getNrOfSections() const {return m_nrOfSections;};
+    /**
+     * @brief computes the coefficient ramps for the next block, has to be called before processChannels
+     *
+     * @param numSamples length of the next block
+     */
+    void prepareBlock(int numSamples)
+    {
+        if (numSamples > 0)
+            prepareRamps(numSamples);
+    }
+    /**
+     * @brief ends the coefficient ramps after all channels of a block are processed
+     *
+     */
+    void finishBlock() {finishRamps();};
+
+protected:
+    // all sections are set to identity and inactive
+    void prepareSections(int nrOfSections)
+    {
+        m_nrOfSections = nrOfSections;
+        m_b0.assign(m_nrOfSections, FloatType(1));
+        m_b1.assign(m_nrOfSections, FloatType(0));
+        m_b2.assign(m_nrOfSections, FloatType(0));
+        m_a1.assign(m_nrOfSections, FloatType(0));
+        m_a2.assign(m_nrOfSections, FloatType(0));
+        m_b0Target = m_b0;
+        m_b1Target = m_b1;
+        m_b2Target = m_b2;
+        m_a1Target = m_a1;
+        m_a2Target = m_a2;
+        m_db0.assign(m_nrOfSections, FloatType(0));
+        m_db1.assign(m_nrOfSections, FloatType(0));
+        m_db2.assign(m_nrOfSections, FloatType(0));
+        m_da1.assign(m_nrOfSections, FloatType(0));
+        m_da2.assign(m_nrOfSections, FloatType(0));
+        m_isRamping.assign(m_nrOfSections, 0);
+        m_anyRamping = false;
+        m_isActive.assign(m_nrOfSections, 0);
+        m_activeSections.clear();
+        m_activeSections.reserve(m_nrOfSections);
+    }
+    // returns true if the section has just become active (its states have to be seeded)
+    bool changeSectionActive(int section, bool isActive)
+    {
+        if ((m_isActive[section] != 0) == isActive)
+            return false;
+
+        m_isActive[section] = isActive ? 1 : 0;
+        // rebuild the list in cascade order (no allocation, memory is reserved in prepareSections)
+        m_activeSections.clear();
+        for (auto kk = 0; kk < m_nrOfSections; ++kk)
+        {
+            if (m_isActive[kk])
+                m_activeSections.push_back(kk);
+        }
+        return isActive;
+    }
+    // the active section in front of section in the cascade, -1 if there is none
+    int getPreviousActiveSection(int section) const
+    {
+        int previous = -1;
+        for (auto kk : m_activeSections)
+        {
+            if (kk >= section)
+                break;
+            previous = kk;
+        }
+        return previous;
+    }
+    // computes the per sample increments of all ramping sections for a block of numSamples
+    void prepareRamps(int numSamples)
+    {
+        if (!m_anyRamping)
+            return;
+        FloatType scale = FloatType(1) / numSamples;
+        for (auto section : m_activeSections)
+        {
+            if (m_isRamping[section])
+            {
+                m_db0[section] = (m_b0Target[section] - m_b0[section]) * scale;
+                m_db1[section] = (m_b1Target[section] - m_b1[section]) * scale;
+                m_db2[section] = (m_b2Target[section] - m_b2[section]) * scale;
+                m_da1[section] = (m_a1Target[section] - m_a1[section]) * scale;
+                m_da2[section] = (m_a2Target[section] - m_a2[section]) * scale;
+            }
+        }
+    }
+    // the ramps end exactly on the target coefficients (also for inactive sections)
+    void finishRamps()
+    {
+        if (!m_anyRamping)
+            return;
+        for (auto section = 0; section < m_nrOfSections; ++section)
+        {
+            if (m_isRamping[section])
+            {
+                m_b0[section] = m_b0Target[section];
+                m_b1[section] = m_b1Target[section];
+                m_b2[section] = m_b2Target[section];
+                m_a1[section] = m_a1Target[section];
+                m_a2[section] = m_a2Target[section];
+                m_isRamping[section] = 0;
+            }
+        }
+        m_anyRamping = false;
+    }
+
+    int m_nrOfSections = 0;
+    // coefficients as structure of arrays, index = section
+    std::vector<FloatType> m_b0;
+    std::vector<FloatType> m_b1;
+    std::vector<FloatType> m_b2;
+    std::vector<FloatType> m_a1;
+    std::vector<FloatType> m_a2;
+    // ramp targets and per sample increments
+    std::vector<FloatType> m_b0Target;
+    std::vector<FloatType> m_b1Target;
+    std::vector<FloatType> m_b2Target;
+    std::vector<FloatType> m_a1Target;
+    std::vector<FloatType> m_a2Target;
+    std::vector<FloatType> m_db0;
+    std::vector<FloatType> m_db1;
+    std::vector<FloatType> m_db2;
+    std::vector<FloatType> m_da1;
+    std::vector<FloatType> m_da2;
+    std::vector<char> m_isRamping;
+    bool m_anyRamping = false;
+
+    std::vector<char> m_isActive;
+    std::vector<int> m_activeSections;
+};
+
+/**
+ * @brief generic version, one Direct Form I cascade per channel
+ *
+ */
+template <typename FloatType>
+class MultiChannelBiquad : public BiquadCascadeSections<FloatType>
+{
+public:
+    MultiChannelBiquad();
+    void prepare(int maxChannels, int nrOfSections = 1);
+    void reset();
+    void setSectionActive(int section, bool isActive);
+    void processBlock(juce::AudioBuffer<FloatType>& data);
+    void processChannels(juce::AudioBuffer<FloatType>& data, int startChannel, int nrOfChannels);
+
+private:
+    struct SectionState
+    {
+        FloatType x1, x2, y1, y2;
+    };
+    void seedSection(int section);
+
+    int m_maxChannels;
+    // index = channel * m_nrOfSections + section
+    std::vector<SectionState> m_states;
+    // last two input samples of the cascade (x1, x2), index = channel
+    std::vector<SectionState> m_inputHistory;
+};
+
+/**
+ * @brief float version, vectorized across channels
+ *
+ */
+template <>
+class MultiChannelBiquad<float> : public BiquadCascadeSections<float>
+{
+public:
+#if MCBIQUAD_USE_AVX
+    static constexpr int c_laneWidth = 8;
+#else
+    static constexpr int c_laneWidth = 4;
+#endif
+
+    MultiChannelBiquad();
+    /**
+     * @brief allocates the state memory for up to maxChannels channels and nrOfSections sections
+     * and resets it (not realtime safe). All sections are set to identity and inactive, except for nrOfSections == 1
+     *
+     * @param maxChannels
+     * @param nrOfSections
+     */
+    void prepare(int maxChannels, int nrOfSections = 1);
+    /**
+     * @brief sets all states to zero
+     *
+     */
+    void reset();
+    /**
+     * @brief inactive sections are skipped. A section that becomes active again starts with the
+     * states of an identity filter (the input history of the section)
+     *
+     * @param section
+     * @param isActive
+     */
+    void setSectionActive(int section, bool isActive);
+    /**
+     * @brief filters all channels of data in place with all active sections
+     * (data must not have more channels than given in prepare)
+     *
+     * @param data
+     */
+    void processBlock(juce::AudioBuffer<float>& data);
+    /**
+     * @brief filters the channels startChannel ... startChannel + nrOfChannels - 1 of data in place,
+     * between prepareBlock and finishBlock. Disjoint ranges can run in parallel, if startChannel is a
+     * multiple of c_laneWidth (no two threads write to the same lane group)
+     *
+     * @param data
+     * @param startChannel
+     * @param nrOfChannels
+     */
+    void processChannels(juce::AudioBuffer<float>& data, int startChannel, int nrOfChannels);
+
+private:
+    // states of one section of one lane group, each entry holds one lane (channel)
+    struct alignas(32) LaneGroupState
+    {
+        float x1[c_laneWidth];
+        float x2[c_laneWidth];
+        float y1[c_laneWidth];
+        float y2[c_laneWidth];
+    };
+
+    void processFullGroup(float* const* channelData, LaneGroupState* states, int numSamples);
+    void processPartialGroup(float* const* channelData, int nrOfLanes, LaneGroupState* states, int numSamples);
+    void resetSection(int section);
+    void seedSection(int section);
+
+    int m_maxChannels;
+    int m_nrOfGroups;
+    // index = group * m_nrOfSections + section
+    std::vector<LaneGroupState> m_states;
+    // last two input samples of the cascade (x1, x2), index = group
+    std::vector<LaneGroupState> m_inputHistory;
+};
@@ -0,0 +1,197 @@
+#include "MultiChannelSVF.h"
+
+template <typename FloatType>
+MultiChannelSVF<FloatType>::MultiChannelSVF()
+:m_maxChannels(0), m_nrOfSections(0), m_anyRamping(false)
+{
+    prepare(2);
+}
+
+template <typename FloatType>
+void MultiChannelSVF<FloatType>::prepare(int maxChannels, int nrOfSections)
+{
+    m_maxChannels = maxChannels;
+    m_nrOfSections = nrOfSections;
+    // identity (m1 = 0) with some valid g and k to ramp from
+    m_g.assign(m_nrOfSections, FloatType(0.1));
+    m_k.assign(m_nrOfSections, FloatType(1));
+    m_m1.assign(m_nrOfSections, FloatType(0));
+    m_gTarget = m_g;
+    m_kTarget = m_k;
+    m_m1Target = m_m1;
+    m_dg.assign(m_nrOfSections, FloatType(0));
+    m_dk.assign(m_nrOfSections, FloatType(0));
+    m_dm1.assign(m_nrOfSections, FloatType(0));
+    m_isRamping.assign(m_nrOfSections, 0);
+    m_anyRamping = false;
+    m_isActive.assign(m_nrOfSections, 0);
+    m_activeSections.clear();
+    m_activeSections.reserve(m_nrOfSections);
+
+    m_states.resize(m_maxChannels * m_nrOfSections);
+    if (m_nrOfSections == 1)
+        setSectionActive(0, true);
+
+    reset();
+}
+
+template <typename FloatType>
+void MultiChannelSVF<FloatType>::reset()
+{
+    for (auto& state : m_states)
+        state = {0, 0};
+}
+
+template <typename FloatType>
+void MultiChannelSVF<FloatType>::setCoefficients(int section, double g, double k, double m1)
+{
+    m_g[section] = static_cast<FloatType>(g);
+    m_k[section] = static_cast<FloatType>(k);
+    m_m1[section] = static_cast<FloatType>(m1);
+    m_isRamping[section] = 0;
+}
+
+template <typename FloatType>
+void MultiChannelSVF<FloatType>::setTargetCoefficients(int section, double g, double k, double m1)
+{
+    m_gTarget[section] = static_cast<FloatType>(g);
+    m_kTarget[section] = static_cast<FloatType>(k);
+    m_m1Target[section] = static_cast<FloatType>(m1);
+    m_isRamping[section] = 1;
+    m_anyRamping = true;
+}
+
+template <typename FloatType>
+void MultiChannelSVF<FloatType>::setIdentity(int section)
+{
+    m_m1[section] = FloatType(0);
+    m_isRamping[section] = 0;
+}
+
+template <typename FloatType>
+void MultiChannelSVF<FloatType>::setSectionActive(int section, bool isActive)
+{
+    if ((m_isActive[section] != 0) == isActive)
+        return;
+
+    m_isActive[section] = isActive ? 1 : 0;
+    // rebuild the list in cascade order (no allocation, memory is reserved in prepare)
+    m_activeSections.clear();
+    for (auto kk = 0; kk < m_nrOfSections; ++kk)
+    {
+        if (m_isActive[kk])
+            m_activeSections.push_back(kk);
+    }
+    if (isActive)
+    {
+        for (auto channel = 0; channel < m_maxChannels; ++channel)
+            m_states[channel * m_nrOfSections + section] = {0, 0};
+    }
+}
+
+template <typename FloatType>
+void MultiChannelSVF<FloatType>::finishBlock()
+{
+    if (!m_anyRamping)
+        return;
+    for (auto section = 0; section < m_nrOfSections; ++section)
+    {
+        if (m_isRamping[section])
+        {
+            m_g[section] = m_gTarget[section];
+            m_k[section] = m_kTarget[section];
+            m_m1[section] = m_m1Target[section];
+            m_isRamping[section] = 0;
+        }
+    }
+    m_anyRamping = false;
+}
+
+template <typename FloatType>
+void MultiChannelSVF<FloatType>::processBlock(juce::AudioBuffer<FloatType>& data)
+{
+    prepareBlock(data.getNumSamples());
+    processChannels(data, 0, data.getNumChannels());
+    finishBlock();
+}
+
+template <typename FloatType>
+void MultiChannelSVF<FloatType>::prepareBlock(int numSamples)
+{
+    if (numSamples == 0)
+        return;
+    FloatType scale = FloatType(1) / numSamples;
+    for (auto section : m_activeSections)
+    {
+        if (m_isRamping[section])
+        {
+            m_dg[section] = (m_gTarget[section] - m_g[section]) * scale;
+            m_dk[section] = (m_kTarget[section] - m_k[section]) * scale;
+            m_dm1[section] = (m_m1Target[section] - m_m1[section]) * scale;
+        }
+    }
+}
+
+template <typename FloatType>
+void MultiChannelSVF<FloatType>::processChannels(juce::AudioBuffer<FloatType>& data, int startChannel, int nrOfChannels)
+{
+    int endChannel = startChannel + nrOfChannels;
+    int numSamples = data.getNumSamples();
+    jassert(endChannel <= m_maxChannels && endChannel <= data.getNumChannels());
+    if (m_activeSections.empty() || numSamples == 0)
+        return;
+
+    for (auto channel = startChannel; channel < endChannel; ++channel)
+    {
+        FloatType* channelData = data.getWritePointer(channel);
+        for (auto section : m_activeSections)
+        {
+            auto& state = m_states[channel * m_nrOfSections + section];
+            FloatType s1 = state.s1;
+            FloatType s2 = state.s2;
+            FloatType g = m_g[section];
+            FloatType k = m_k[section];
+            FloatType m1 = m_m1[section];
+            if (m_isRamping[section])
+            {
+                for (auto sample = 0; sample < numSamples; ++sample)
+                {
+                    g += m_dg[section];
+                    k += m_dk[section];
+                    m1 += m_dm1[section];
+                    FloatType a1 = FloatType(1) / (FloatType(1) + g * (g + k));
+                    FloatType a2 = g * a1;
+                    FloatType a3 = g * a2;
+                    FloatType x = channelData[sample];
+                    FloatType v3 = x - s2;
+                    FloatType v1 = a1 * s1 + a2 * v3;
+                    FloatType v2 = s2 + a2 * s1 + a3 * v3;
+                    s1 = FloatType(2) * v1 - s1;
+                    s2 = FloatType(2) * v2 - s2;
+                    channelData[sample] = x + m1 * v1;
+                }
+            }
+            else
+            {
+                FloatType a1 = FloatType(1) / (FloatType(1) + g * (g + k));
+                FloatType a2 = g * a1;
+                FloatType a3 = g * a2;
+                for (auto sample = 0; sample < numSamples; ++sample)
+                {
+                    FloatType x = channelData[sample];
+                    FloatType v3 = x - s2;
+                    FloatType v1 = a1 * s1 + a2 * v3;
+                    FloatType v2 = s2 + a2 * s1 + a3 * v3;
+                    s1 = FloatType(2) * v1 - s1;
+                    s2 = FloatType(2) * v2 - s2;
+                    channelData[sample] = x + m1 * v1;
+                }
+            }
+            state.s1 = s1;
+            state.s2 = s2;
+        }
+    }
+}
+
+template class MultiChannelSVF<float>;
+template class MultiChannelSVF<double>;
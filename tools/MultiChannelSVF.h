@@ -0,0 +1,132 @@
+/**
+ * @file MultiChannelSVF.h
+ * @author J. Bitzer @ Jade HS, BSD Licence
+ * @brief cascade of TPT state variable peak filters (trapezoidal SVF, see designPeakEqualizerSVF) for many channels
+ * Alternative topology to MultiChannelBiquad with the same interface. Each section is
+ * parametrized by (g, k, m1) instead of (b, a). The SVF is stable for all g, k > 0,
+ * therefore the parameters can be ramped sample by sample without any restriction and
+ * the SVF keeps a low noise floor for low center frequencies in float, where the
+ * Direct Form I suffers from coefficient quantization (a1 close to -2, a2 close to 1).
+ * The price is one division per sample and section while ramping.
+ * Sections that become active start with zero states, a section switched on as
+ * identity (m1 = 0, see setIdentity) and ramped to its design is nevertheless click-free,
+ * since the band pass state is only mixed in with the ramped m1.
+ * Usage: prepare(maxChannels, nrOfSections), setCoefficients(section,g,k,m1),
+ * setSectionActive(section,true), processBlock(buffer)
+ * For parallel processing processBlock can be split into prepareBlock(numSamples),
+ * processChannels(buffer, start, nr) for disjoint channel ranges (on any thread) and finishBlock().
+ * @version 1.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+// Version 1.0 cascade of sections with per sample parameter ramps
+// Version 1.1 processing of channel ranges (prepareBlock, processChannels, finishBlock)
+
+#pragma once
+#include <vector>
+#include <JuceHeader.h>
+
+template <typename FloatType>
+class MultiChannelSVF
+{
+public:
+    MultiChannelSVF();
+    /**
+     * @brief allocates the state memory for up to maxChannels channels and nrOfSections sections
+     * and resets it (not realtime safe). All sections are set to identity and inactive, except for nrOfSections == 1
+     *
+     * @param maxChannels
+     * @param nrOfSections
+     */
+    void prepare(int maxChannels, int nrOfSections = 1);
+    /**
+     * @brief sets all states to zero
+     *
+     */
+    void reset();
+    /**
+     * @brief sets the parameters (g, k, m1) of one section (see designPeakEqualizerSVF)
+     *
+     * @param section index of the section in the cascade
+     */
+    void setCoefficients(int section, double g, double k, double m1);
+    /**
+     * @brief same as setCoefficients, but the parameters ramp linearly from the current ones
+     * to the new ones over the next processBlock call (the last sample uses the new parameters)
+     *
+     * @param section index of the section in the cascade
+     */
+    void setTargetCoefficients(int section, double g, double k, double m1);
+    /**
+     * @brief sets m1 of one section to 0 (identity), g and k are kept as start of a ramp
+     *
+     * @param section index of the section in the cascade
+     */
+    void setIdentity(int section);
+    /**
+     * @brief inactive sections are skipped, a section that becomes active starts with zero states
+     *
+     * @param section
+     * @param isActive
+     */
+    void setSectionActive(int section, bool isActive);
+    bool isSectionActive(int section) const {return m_isActive[section] != 0;};
+    int getNrOfActiveSections() const {return static_cast<int>(m_activeSections.size());};
+    int getNrOfSections() const {return m_nrOfSections;};
+    /**
+     * @brief filters all channels of data in place with all active sections
+     * (data must not have more channels than given in prepare)
+     *
+     * @param data
+     */
+    void processBlock(juce::AudioBuffer<FloatType>& data);
+    /**
+     * @brief computes the parameter ramps for the next block, has to be called before processChannels
+     *
+     * @param numSamples length of the next block
+     */
+    void prepareBlock(int numSamples);
+    /**
+     * @brief filters the channels startChannel ... startChannel + nrOfChannels - 1 of data in place,
+     * between prepareBlock and finishBlock. Disjoint ranges can run in parallel
+     *
+     * @param data
+     * @param startChannel
+     * @param nrOfChannels
+     */
+    void processChannels(juce::AudioBuffer<FloatType>& data, int startChannel, int nrOfChannels);
+    /**
+     * @brief ends the parameter ramps after all channels of a block are processed
+     *
+     */
+    void finishBlock();
+
+private:
+    struct SectionState
+    {
+        FloatType s1, s2;
+    };
+
+    int m_maxChannels;
+    int m_nrOfSections;
+    // parameters as structure of arrays, index = section
+    std::vector<FloatType> m_g;
+    std::vector<FloatType> m_k;
+    std::vector<FloatType> m_m1;
+    // ramp targets and per sample increments
+    std::vector<FloatType> m_gTarget;
+    std::vector<FloatType> m_kTarget;
+    std::vector<FloatType> m_m1Target;
+    std::vector<FloatType> m_dg;
+    std::vector<FloatType> m_dk;
+    std::vector<FloatType> m_dm1;
+    std::vector<char> m_isRamping;
+    bool m_anyRamping;
+
+    std::vector<char> m_isActive;
+    std::vector<int> m_activeSections;
+    // index = channel * m_nrOfSections + section
+    std::vector<SectionState> m_states;
+};
@@ -0,0 +1,178 @@
+#include <cmath>
+#include <cstring>
+#include "PartitionedConvolver.h"
+
+template <typename FloatType>
+PartitionedConvolver<FloatType>::PartitionedConvolver()
+:m_partitionSize(0), m_nrOfBins(0), m_maxPartitions(0), m_crossfadeLength(0), m_delayLinePosition(0)
+{
+}
+
+template <typename FloatType>
+void PartitionedConvolver<FloatType>::prepare(int maxChannels, double sampleRate, int maxFIRLength, int crossfadeBlocks)
+{
+    m_partitionSize = juce::nextPowerOfTwo(juce::jmax(16, static_cast<int>(round(g_desired_blocksize_ms * sampleRate * 0.001))));
+    m_nrOfBins = m_partitionSize + 1;
+    m_maxPartitions = juce::jmax(1, (maxFIRLength + m_partitionSize - 1) / m_partitionSize);
+    m_crossfadeLength = juce::jmax(1, crossfadeBlocks) * m_partitionSize;
+    m_delayLinePosition = 0;
+    m_fft = std::make_unique<juce::dsp::FFT>(static_cast<int>(log2(2 * m_partitionSize) + 0.5));
+
+    m_channels.clear();
+    for (auto cc = 0; cc < maxChannels; ++cc)
+    {
+        auto channel = std::make_unique<Channel>();
+        for (auto& slot : channel->slots)
+            slot.partitions.assign(2 * m_nrOfBins * m_maxPartitions, 0.f);
+        // unit impulse: the first partition is 1 at all bins
+        std::fill(channel->slots[0].partitions.begin(), channel->slots[0].partitions.begin() + m_nrOfBins, 1.f);
+        channel->slots[0].nrOfPartitions = 1;
+        channel->input.assign(2 * m_partitionSize, 0.f);
+        channel->delayLine.assign(2 * m_nrOfBins * m_maxPartitions, 0.f);
+        m_channels.push_back(std::move(channel));
+    }
+    // the real only transforms need twice the FFT size
+    m_work.assign(4 * m_partitionSize, 0.f);
+    m_accumulator.assign(2 * m_nrOfBins, 0.f);
+    m_output.assign(m_partitionSize, 0.f);
+    m_targetOutput.assign(m_partitionSize, 0.f);
+    m_writerWork.assign(4 * m_partitionSize, 0.f);
+
+    this->prepareSynchronProcessing(maxChannels, m_partitionSize);
+}
+
+template <typename FloatType>
+void PartitionedConvolver<FloatType>::setFIR(int channel, const FloatType* fir, int length)
+{
+    ScopedLock lock(m_protectSetFIR);
+    jassert(channel < static_cast<int>(m_channels.size()));
+    jassert(length <= m_maxPartitions * m_partitionSize);
+    auto& state = *m_channels[channel];
+    auto& filter = state.slots[state.writeSlot];
+    length = juce::jmin(length, m_maxPartitions * m_partitionSize);
+
+    // each partition zero padded to 2B
+    filter.nrOfPartitions = (length + m_partitionSize - 1) / m_partitionSize;
+    for (auto partition = 0; partition < filter.nrOfPartitions; ++partition)
+    {
+        std::fill(m_writerWork.begin(), m_writerWork.end(), 0.f);
+        int partitionLength = juce::jmin(m_partitionSize, length - partition * m_partitionSize);
+        for (auto kk = 0; kk < partitionLength; ++kk)
+            m_writerWork[kk] = static_cast<float>(fir[partition * m_partitionSize + kk]);
+        m_fft->performRealOnlyForwardTransform(m_writerWork.data(), true);
+        splitSpectrum(m_writerWork.data(), &filter.partitions[2 * m_nrOfBins * partition]);
+    }
+    // the previous published slot (taken by the audio thread or not) is the next one to write
+    state.writeSlot = state.published.exchange(state.writeSlot | c_newFlag) & c_slotMask;
+}
+
+template <typename FloatType>
+void PartitionedConvolver<FloatType>::accumulate(const Channel& channel, const FilterSpectra& filter)
+{
+    float* real = m_accumulator.data();
+    float* imag = real + m_nrOfBins;
+    std::fill(real, real + 2 * m_nrOfBins, 0.f);
+    for (auto partition = 0; partition < filter.nrOfPartitions; ++partition)
+    {
+        // partition p is multiplied with the input spectrum of p blocks ago
+        int position = m_delayLinePosition - partition;
+        if (position < 0)
+            position += m_maxPartitions;
+        const float* xReal = &channel.delayLine[2 * m_nrOfBins * position];
+        const float* xImag = xReal + m_nrOfBins;
+        const float* hReal = &filter.partitions[2 * m_nrOfBins * partition];
+        const float* hImag = hReal + m_nrOfBins;
+        for (auto kk = 0; kk < m_nrOfBins; ++kk)
+        {
+            real[kk] += xReal[kk] * hReal[kk] - xImag[kk] * hImag[kk];
+            imag[kk] += xReal[kk] * hImag[kk] + xImag[kk] * hReal[kk];
+        }
+    }
+}
+
+template <typename FloatType>
+void PartitionedConvolver<FloatType>::inverseTransform(float* output)
+{
+    for (auto kk = 0; kk < m_nrOfBins; ++kk)
+    {
+        m_work[2 * kk] = m_accumulator[kk];
+        m_work[2 * kk + 1] = m_accumulator[m_nrOfBins + kk];
+    }
+    // overlap-save: the first B samples of the frame are circular convolution errors
+    m_fft->performRealOnlyInverseTransform(m_work.data());
+    std::memcpy(output, m_work.data() + m_partitionSize, m_partitionSize * sizeof(float));
+}
+
+template <typename FloatType>
+void PartitionedConvolver<FloatType>::splitSpectrum(const float* interleaved, float* split)
+{
+    for (auto kk = 0; kk < m_nrOfBins; ++kk)
+    {
+        split[kk] = interleaved[2 * kk];
+        split[m_nrOfBins + kk] = interleaved[2 * kk + 1];
+    }
+}
+
+template <typename FloatType>
+int PartitionedConvolver<FloatType>::processSynchronBlock(juce::AudioBuffer<FloatType>& block, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    if (++m_delayLinePosition == m_maxPartitions)
+        m_delayLinePosition = 0;
+
+    int nrOfChannels = juce::jmin(block.getNumChannels(), static_cast<int>(m_channels.size()));
+    for (auto cc = 0; cc < nrOfChannels; ++cc)
+    {
+        auto& channel = *m_channels[cc];
+        FloatType* data = block.getWritePointer(cc);
+
+        // the newest published FIR, only if no crossfade is running (the spare slot is exchanged)
+        if (channel.target < 0 && (channel.published.load() & c_newFlag) != 0)
+        {
+            channel.target = channel.published.exchange(channel.spare) & c_slotMask;
+            channel.spare = -1;
+            channel.fadePosition = 0;
+        }
+
+        // input frame: previous and current block
+        std::memmove(channel.input.data(), channel.input.data() + m_partitionSize, m_partitionSize * sizeof(float));
+        for (auto kk = 0; kk < m_partitionSize; ++kk)
+            channel.input[m_partitionSize + kk] = static_cast<float>(data[kk]);
+        std::memcpy(m_work.data(), channel.input.data(), 2 * m_partitionSize * sizeof(float));
+        m_fft->performRealOnlyForwardTransform(m_work.data(), true);
+        splitSpectrum(m_work.data(), &channel.delayLine[2 * m_nrOfBins * m_delayLinePosition]);
+
+        accumulate(channel, channel.slots[channel.current]);
+        inverseTransform(m_output.data());
+        if (channel.target < 0)
+        {
+            for (auto kk = 0; kk < m_partitionSize; ++kk)
+                data[kk] = static_cast<FloatType>(m_output[kk]);
+            continue;
+        }
+
+        // linear crossfade from the current to the target filter output
+        accumulate(channel, channel.slots[channel.target]);
+        inverseTransform(m_targetOutput.data());
+        float gainStep = 1.f / m_crossfadeLength;
+        for (auto kk = 0; kk < m_partitionSize; ++kk)
+        {
+            float gain = (channel.fadePosition + kk) * gainStep;
+            data[kk] = static_cast<FloatType>(m_output[kk] + gain * (m_targetOutput[kk] - m_output[kk]));
+        }
+        channel.fadePosition += m_partitionSize;
+        if (channel.fadePosition >= m_crossfadeLength)
+        {
+            channel.spare = channel.current;
+            channel.current = channel.target;
+            channel.target = -1;
+        }
+    }
+    // channels without a filter state (more channels than prepared) are muted
+    for (auto cc = nrOfChannels; cc < block.getNumChannels(); ++cc)
+        block.clear(cc, 0, m_partitionSize);
+    return 0;
+}
+
+template class PartitionedConvolver<float>;
+template class PartitionedConvolver<double>;
@@ -0,0 +1,114 @@
+/**
+ * @file PartitionedConvolver.h
+ * @author J. Bitzer @ Jade HS, BSD Licence
+ * @brief multichannel FIR filter with uniformly partitioned overlap-save convolution (UPOLS)
+ * The FIR is split into partitions of the synchron block length B (g_desired_blocksize_ms at the
+ * sampling rate, rounded up to a power of 2). Every block is transformed once (FFT of 2B) and kept in a
+ * frequency domain delay line, the output spectrum is the sum of the delayed input spectra times the
+ * partition spectra, one inverse FFT per block and channel. The latency is B samples (getLatency),
+ * independent of the FIR length, the cost per sample and channel is one FFT pair of 2B plus L/B complex
+ * multiplications per bin (the multiplications dominate for long filters, see tester/benchmark).
+ * The FIR of each channel can be replaced at any time with setFIR (not from the audio thread):
+ * the spectra are computed by the caller and published lock free, the audio thread crossfades from
+ * the old to the new output over crossfadeBlocks blocks. Updates during a crossfade are not lost,
+ * the newest one is used after the running crossfade.
+ * The FFT runs in float (juce::dsp::FFT), for double the blocks are converted.
+ * Usage: prepare(maxChannels, sampleRate, maxFIRLength), setFIR(channel, fir, length),
+ * processBlock(buffer, midi) (any block size). Without setFIR a channel passes the signal (delayed by B).
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+// Version 1.0 uniform partitions, frequency domain delay line, lock free FIR updates with crossfade
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <JuceHeader.h>
+#include "SynchronBlockProcessor.h"
+#include "../PluginSettings.h"
+
+template <typename FloatType>
+class PartitionedConvolver : public SynchronBlockProcessor<FloatType>
+{
+public:
+    PartitionedConvolver();
+    /**
+     * @brief allocates all buffers for FIR filters up to maxFIRLength, every channel passes the signal
+     * afterwards (not realtime safe, not concurrent to setFIR or processBlock)
+     *
+     * @param maxChannels
+     * @param sampleRate sets the partition size (g_desired_blocksize_ms, rounded up to a power of 2)
+     * @param maxFIRLength longest FIR given to setFIR
+     * @param crossfadeBlocks length of the crossfade after a FIR update in partitions
+     */
+    void prepare(int maxChannels, double sampleRate, int maxFIRLength, int crossfadeBlocks = 8);
+    /**
+     * @brief replaces the FIR of one channel, the crossfade to the new filter starts with the next block
+     * (not from the audio thread, calls from several threads are serialized)
+     *
+     * @param channel
+     * @param fir impulse response
+     * @param length at most maxFIRLength, shorter filters cost less
+     */
+    void setFIR(int channel, const FloatType* fir, int length);
+    int getPartitionSize() const {return m_partitionSize;};
+    int getLatency() {return this->getDelay();};
+
+    int processSynchronBlock(juce::AudioBuffer<FloatType>& block, juce::MidiBuffer& midiMessages) override;
+
+private:
+    // four sets of partition spectra per channel: two used by the audio thread (current and the
+    // crossfade target or a spare one), one written by setFIR and one exchanged between both
+    static constexpr int c_nrOfSlots = 4;
+    static constexpr int c_newFlag = 8;
+    static constexpr int c_slotMask = 7;
+
+    struct FilterSpectra
+    {
+        // per partition the real parts of bins 0 ... B followed by the imaginary parts (partition major)
+        std::vector<float> partitions;
+        int nrOfPartitions = 0;
+    };
+    struct Channel
+    {
+        FilterSpectra slots[c_nrOfSlots];
+        // index of the exchanged slot, c_newFlag if setFIR published it and the audio thread has not taken it
+        std::atomic<int> published{2};
+        int writeSlot = 3; // setFIR
+        int current = 0; // audio thread
+        int spare = 1;
+        int target = -1;
+        int fadePosition = 0;
+        // previous and current input block
+        std::vector<float> input;
+        // spectra of the last maxPartitions input blocks (same layout as FilterSpectra)
+        std::vector<float> delayLine;
+    };
+    // sum of the delayed input spectra times the partition spectra into m_accumulator
+    void accumulate(const Channel& channel, const FilterSpectra& filter);
+    // inverse FFT of m_accumulator, the last B samples of the frame to output
+    void inverseTransform(float* output);
+    // interleaved FFT output to real and imaginary parts
+    void splitSpectrum(const float* interleaved, float* split);
+
+    int m_partitionSize;
+    int m_nrOfBins;
+    int m_maxPartitions;
+    int m_crossfadeLength;
+    int m_delayLinePosition;
+    // the transforms are const, the audio thread and setFIR share them
+    std::unique_ptr<juce::dsp::FFT> m_fft;
+    std::vector<std::unique_ptr<Channel>> m_channels;
+    // audio thread
+    std::vector<float> m_work;
+    std::vector<float> m_accumulator; // real parts followed by the imaginary parts
+    std::vector<float> m_output;
+    std::vector<float> m_targetOutput;
+    // setFIR
+    CriticalSection m_protectSetFIR;
+    std::vector<float> m_writerWork;
+};
@@ -0,0 +1,272 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstring>
+#include "PolyphaseOversampler.h"
+
+#if defined(__AVX__)
+    #include <immintrin.h>
+    #define POLYPHASE_USE_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define POLYPHASE_USE_SSE 1
+#endif
+
+namespace
+{
+    // first stage: long filter with a narrow transition band, second stage: short filter
+    const int c_halfLengthFirstStage = 24;
+    const double c_kaiserBetaFirstStage = 8.0;
+    const int c_halfLengthSecondStage = 6;
+    const double c_kaiserBetaSecondStage = 7.0;
+
+    // y[kk] = sum_ll coefficients[ll] * x[kk + ll], kk = 0 ... numSamples-1
+    template <typename FloatType>
+    void correlate(const FloatType* x, const FloatType* coefficients, int nrOfTaps, FloatType* y, int numSamples)
+    {
+        for (auto kk = 0; kk < numSamples; ++kk)
+        {
+            FloatType sum = 0;
+            for (auto ll = 0; ll < nrOfTaps; ++ll)
+                sum += coefficients[ll] * x[kk + ll];
+            y[kk] = sum;
+        }
+    }
+
+    // float: vectorized over consecutive outputs (same summation order as above)
+    void correlate(const float* x, const float* coefficients, int nrOfTaps, float* y, int numSamples)
+    {
+        int kk = 0;
+#if POLYPHASE_USE_AVX
+        for (; kk + 8 <= numSamples; kk += 8)
+        {
+            __m256 sum = _mm256_setzero_ps();
+            for (auto ll = 0; ll < nrOfTaps; ++ll)
+                sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(coefficients[ll]), _mm256_loadu_ps(x + kk + ll)));
+            _mm256_storeu_ps(y + kk, sum);
+        }
+#endif
+#if POLYPHASE_USE_AVX || POLYPHASE_USE_SSE
+        for (; kk + 4 <= numSamples; kk += 4)
+        {
+            __m128 sum = _mm_setzero_ps();
+            for (auto ll = 0; ll < nrOfTaps; ++ll)
+                sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(coefficients[ll]), _mm_loadu_ps(x + kk + ll)));
+            _mm_storeu_ps(y + kk, sum);
+        }
+#endif
+        for (; kk < numSamples; ++kk)
+        {
+            float sum = 0.f;
+            for (auto ll = 0; ll < nrOfTaps; ++ll)
+                sum += coefficients[ll] * x[kk + ll];
+            y[kk] = sum;
+        }
+    }
+
+    // modified Bessel function of the first kind, order 0 (series)
+    double besselI0(double x)
+    {
+        double sum = 1.0;
+        double term = 1.0;
+        for (auto kk = 1; kk < 50; ++kk)
+        {
+            term *= (0.5 * x / kk) * (0.5 * x / kk);
+            sum += term;
+            if (term < 1e-12 * sum)
+                break;
+        }
+        return sum;
+    }
+}
+
+template <typename FloatType>
+void PolyphaseOversampler<FloatType>::HalfbandStage::prepare(int maxChannels, int maxInputSamples, int halfLength,
+                                                             double kaiserBeta, int extraDelay)
+{
+    m_halfLength = halfLength;
+    m_extraDelay = extraDelay;
+    m_maxInputSamples = maxInputSamples;
+
+    // Kaiser windowed sinc (N = 4 m - 1 taps) with cut off at a quarter of the (higher) sampling rate
+    int center = 2 * halfLength - 1;
+    std::vector<double> evenTaps(2 * halfLength);
+    double sum = 0.0;
+    for (auto kk = 0; kk < 2 * halfLength; ++kk)
+    {
+        double n = 2.0 * kk - center;
+        double t = n / center; // position in the window, -1 ... 1
+        double window = besselI0(kaiserBeta * sqrt(juce::jmax(0.0, 1.0 - t * t))) / besselI0(kaiserBeta);
+        evenTaps[kk] = sin(0.5 * M_PI * n) / (M_PI * n) * window;
+        sum += evenTaps[kk];
+    }
+    // the even branch has a DC gain of exactly 0.5, as the odd branch (the center tap)
+    m_upCoefficients.resize(evenTaps.size());
+    m_downCoefficients.resize(evenTaps.size());
+    for (size_t kk = 0; kk < evenTaps.size(); ++kk)
+    {
+        m_downCoefficients[kk] = static_cast<FloatType>(0.5 * evenTaps[kk] / sum);
+        m_upCoefficients[kk] = static_cast<FloatType>(evenTaps[kk] / sum);
+    }
+
+    m_upStride = 2 * halfLength - 1 + maxInputSamples;
+    m_evenStride = 2 * halfLength - 1 + extraDelay + maxInputSamples;
+    m_oddStride = halfLength + extraDelay + maxInputSamples;
+    m_upBuffer.assign(maxChannels * m_upStride, FloatType(0));
+    m_evenBuffer.assign(maxChannels * m_evenStride, FloatType(0));
+    m_oddBuffer.assign(maxChannels * m_oddStride, FloatType(0));
+    m_work.assign(maxChannels * maxInputSamples, FloatType(0));
+}
+
+template <typename FloatType>
+void PolyphaseOversampler<FloatType>::HalfbandStage::reset()
+{
+    std::fill(m_upBuffer.begin(), m_upBuffer.end(), FloatType(0));
+    std::fill(m_evenBuffer.begin(), m_evenBuffer.end(), FloatType(0));
+    std::fill(m_oddBuffer.begin(), m_oddBuffer.end(), FloatType(0));
+}
+
+template <typename FloatType>
+void PolyphaseOversampler<FloatType>::HalfbandStage::upsample(int channel, const FloatType* input, FloatType* output, int numSamples)
+{
+    jassert(numSamples <= m_maxInputSamples);
+    int historyLength = 2 * m_halfLength - 1;
+    FloatType* buffer = &m_upBuffer[channel * m_upStride];
+    std::memcpy(buffer + historyLength, input, numSamples * sizeof(FloatType));
+
+    // even outputs: FIR branch, odd outputs: the input delayed by m-1 samples
+    FloatType* work = &m_work[channel * m_maxInputSamples];
+    correlate(buffer, m_upCoefficients.data(), 2 * m_halfLength, work, numSamples);
+    const FloatType* delayed = buffer + m_halfLength;
+    for (auto kk = 0; kk < numSamples; ++kk)
+    {
+        output[2 * kk] = work[kk];
+        output[2 * kk + 1] = delayed[kk];
+    }
+    std::memmove(buffer, buffer + numSamples, historyLength * sizeof(FloatType));
+}
+
+template <typename FloatType>
+void PolyphaseOversampler<FloatType>::HalfbandStage::downsample(int channel, const FloatType* input, FloatType* output, int numSamples)
+{
+    jassert(numSamples <= m_maxInputSamples);
+    int evenHistoryLength = 2 * m_halfLength - 1 + m_extraDelay;
+    int oddHistoryLength = m_halfLength + m_extraDelay;
+    FloatType* even = &m_evenBuffer[channel * m_evenStride];
+    FloatType* odd = &m_oddBuffer[channel * m_oddStride];
+    for (auto kk = 0; kk < numSamples; ++kk)
+    {
+        even[evenHistoryLength + kk] = input[2 * kk];
+        odd[oddHistoryLength + kk] = input[2 * kk + 1];
+    }
+
+    // even samples: FIR branch, odd samples: center tap 0.5, delayed by m samples (plus the extra delay in both)
+    correlate(even, m_downCoefficients.data(), 2 * m_halfLength, output, numSamples);
+    for (auto kk = 0; kk < numSamples; ++kk)
+        output[kk] += FloatType(0.5) * odd[kk];
+
+    std::memmove(even, even + numSamples, evenHistoryLength * sizeof(FloatType));
+    std::memmove(odd, odd + numSamples, oddHistoryLength * sizeof(FloatType));
+}
+
+template <typename FloatType>
+PolyphaseOversampler<FloatType>::PolyphaseOversampler()
+:m_factor(1), m_latency(0), m_maxBlockSize(0), m_numSamples(0)
+{
+}
+
+template <typename FloatType>
+void PolyphaseOversampler<FloatType>::prepare(int maxChannels, int maxBlockSize, int factor)
+{
+    jassert(factor == 1 || factor == 2 || factor == 4);
+    m_factor = factor;
+    m_maxBlockSize = maxBlockSize;
+    m_numSamples = 0;
+    m_stages.clear();
+    m_latency = 0;
+    if (m_factor >= 2)
+    {
+        m_stages.emplace_back();
+        m_stages[0].prepare(maxChannels, maxBlockSize, c_halfLengthFirstStage, c_kaiserBetaFirstStage, 0);
+        m_latency = m_stages[0].getLatency();
+        m_buffer2x.setSize(maxChannels, 2 * maxBlockSize);
+    }
+    if (m_factor == 4)
+    {
+        // the latency of this stage (at 2 fs) is odd, one more sample makes it an integer at fs
+        m_stages.emplace_back();
+        m_stages[1].prepare(maxChannels, 2 * maxBlockSize, c_halfLengthSecondStage, c_kaiserBetaSecondStage, 1);
+        m_latency += m_stages[1].getLatency() / 2;
+        m_buffer4x.setSize(maxChannels, 4 * maxBlockSize);
+    }
+}
+
+template <typename FloatType>
+void PolyphaseOversampler<FloatType>::reset()
+{
+    for (auto& stage : m_stages)
+        stage.reset();
+}
+
+template <typename FloatType>
+juce::AudioBuffer<FloatType>& PolyphaseOversampler<FloatType>::upsample(juce::AudioBuffer<FloatType>& input)
+{
+    auto& oversampled = prepareBlock(input);
+    upsampleChannels(input, 0, input.getNumChannels());
+    return oversampled;
+}
+
+template <typename FloatType>
+void PolyphaseOversampler<FloatType>::downsample(juce::AudioBuffer<FloatType>& output)
+{
+    downsampleChannels(output, 0, output.getNumChannels());
+}
+
+template <typename FloatType>
+juce::AudioBuffer<FloatType>& PolyphaseOversampler<FloatType>::prepareBlock(juce::AudioBuffer<FloatType>& input)
+{
+    if (m_factor == 1)
+        return input;
+
+    int nrOfChannels = input.getNumChannels();
+    m_numSamples = input.getNumSamples();
+    jassert(m_numSamples <= m_maxBlockSize);
+    // the memory is allocated in prepare, setSize only changes the size
+    m_buffer2x.setSize(nrOfChannels, 2 * m_numSamples, false, false, true);
+    if (m_factor == 2)
+        return m_buffer2x;
+    m_buffer4x.setSize(nrOfChannels, 4 * m_numSamples, false, false, true);
+    return m_buffer4x;
+}
+
+template <typename FloatType>
+void PolyphaseOversampler<FloatType>::upsampleChannels(const juce::AudioBuffer<FloatType>& input, int startChannel, int nrOfChannels)
+{
+    if (m_factor == 1)
+        return;
+
+    jassert(input.getNumSamples() == m_numSamples);
+    for (auto cc = startChannel; cc < startChannel + nrOfChannels; ++cc)
+    {
+        m_stages[0].upsample(cc, input.getReadPointer(cc), m_buffer2x.getWritePointer(cc), m_numSamples);
+        if (m_factor == 4)
+            m_stages[1].upsample(cc, m_buffer2x.getReadPointer(cc), m_buffer4x.getWritePointer(cc), 2 * m_numSamples);
+    }
+}
+
+template <typename FloatType>
+void PolyphaseOversampler<FloatType>::downsampleChannels(juce::AudioBuffer<FloatType>& output, int startChannel, int nrOfChannels)
+{
+    if (m_factor == 1)
+        return;
+
+    jassert(output.getNumSamples() == m_numSamples);
+    for (auto cc = startChannel; cc < startChannel + nrOfChannels; ++cc)
+    {
+        if (m_factor == 4)
+            m_stages[1].downsample(cc, m_buffer4x.getReadPointer(cc), m_buffer2x.getWritePointer(cc), 2 * m_numSamples);
+        m_stages[0].downsample(cc, m_buffer2x.getReadPointer(cc), output.getWritePointer(cc), m_numSamples);
+    }
+}
+
+template class PolyphaseOversampler<float>;
+template class PolyphaseOversampler<double>;
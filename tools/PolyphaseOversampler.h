@@ -0,0 +1,134 @@
+/**
+ * @file PolyphaseOversampler.h
+ * @author J. Bitzer @ Jade HS, BSD Licence
+ * @brief 2x / 4x oversampling with cascaded linear phase half-band FIR filters in polyphase form
+ * Each stage doubles the sampling rate: the even polyphase branch is a short symmetric FIR,
+ * the odd branch of a half-band filter is a pure delay (h = 0.5 at the center, all other odd taps are 0),
+ * therefore every stage costs about N/2 multiplications per input sample for up and for down sampling.
+ * The float FIR is vectorized over consecutive output samples (SSE / AVX), double is plain C++.
+ * The first stage (Kaiser window, 95 taps) passes up to 0.447 fs (ripple < 0.01 dB), images and
+ * aliases are attenuated by more than 70 dB (95 dB below 0.3 fs), the second stage (23 taps) only
+ * needs a wide transition band.
+ * The latency of up and down sampling together is an integer number of samples at the base rate
+ * (getLatency, the second stage is delayed by one sample at the doubled rate to achieve this).
+ * Usage: prepare(maxChannels, maxBlockSize, factor), then per block
+ * auto& oversampled = upsample(buffer); process(oversampled); downsample(buffer);
+ * or for parallel processing of channel ranges (on any thread)
+ * auto& oversampled = prepareBlock(buffer); and per range upsampleChannels, process, downsampleChannels
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+// Version 1.0 half-band stages for factor 1, 2 and 4
+
+#pragma once
+#include <vector>
+#include <JuceHeader.h>
+
+template <typename FloatType>
+class PolyphaseOversampler
+{
+public:
+    PolyphaseOversampler();
+    /**
+     * @brief allocates the buffers and resets the filters (not realtime safe)
+     *
+     * @param maxChannels
+     * @param maxBlockSize largest block (at the base rate) given to upsample
+     * @param factor 1 (no oversampling), 2 or 4
+     */
+    void prepare(int maxChannels, int maxBlockSize, int factor);
+    /**
+     * @brief sets all filter states to zero
+     *
+     */
+    void reset();
+    int getFactor() const {return m_factor;};
+    /**
+     * @brief latency of upsample and downsample together in samples at the base rate
+     *
+     */
+    int getLatency() const {return m_latency;};
+    /**
+     * @brief upsamples all channels of input
+     *
+     * @param input at most maxBlockSize samples
+     * @return buffer with factor * input.getNumSamples() samples (valid until the next call, input itself for factor 1)
+     */
+    juce::AudioBuffer<FloatType>& upsample(juce::AudioBuffer<FloatType>& input);
+    /**
+     * @brief downsamples the buffer returned by the last upsample call into output
+     *
+     * @param output same size as the input of the last upsample call
+     */
+    void downsample(juce::AudioBuffer<FloatType>& output);
+    /**
+     * @brief sets the size of the oversampled buffer for input (no allocation), first step of upsample
+     *
+     * @param input at most maxBlockSize samples
+     * @return buffer with factor * input.getNumSamples() samples (input itself for factor 1)
+     */
+    juce::AudioBuffer<FloatType>& prepareBlock(juce::AudioBuffer<FloatType>& input);
+    /**
+     * @brief upsamples the channels startChannel ... startChannel + nrOfChannels - 1 of input into the
+     * buffer returned by prepareBlock, disjoint channel ranges can run in parallel
+     *
+     */
+    void upsampleChannels(const juce::AudioBuffer<FloatType>& input, int startChannel, int nrOfChannels);
+    /**
+     * @brief downsamples the channels startChannel ... startChannel + nrOfChannels - 1 into output,
+     * disjoint channel ranges can run in parallel
+     *
+     */
+    void downsampleChannels(juce::AudioBuffer<FloatType>& output, int startChannel, int nrOfChannels);
+
+private:
+    // one doubling of the sampling rate (up and down sampling), all channels
+    class HalfbandStage
+    {
+    public:
+        /**
+         * @brief designs the half-band filter with N = 4 * halfLength - 1 taps
+         *
+         * @param halfLength m, the even branch has 2m taps
+         * @param kaiserBeta window parameter (stop band attenuation)
+         * @param extraDelay additional delay of the downsampled output (input rate samples)
+         */
+        void prepare(int maxChannels, int maxInputSamples, int halfLength, double kaiserBeta, int extraDelay);
+        void reset();
+        // latency of up and down sampling together, in samples at the lower rate
+        int getLatency() const {return 2 * m_halfLength - 1 + m_extraDelay;};
+        // numSamples input samples to 2 * numSamples output samples
+        void upsample(int channel, const FloatType* input, FloatType* output, int numSamples);
+        // 2 * numSamples input samples to numSamples output samples
+        void downsample(int channel, const FloatType* input, FloatType* output, int numSamples);
+
+    private:
+        int m_halfLength = 0;
+        int m_extraDelay = 0;
+        int m_maxInputSamples = 0;
+        // even branch (2m taps, symmetric), for up sampling scaled by 2
+        std::vector<FloatType> m_upCoefficients;
+        std::vector<FloatType> m_downCoefficients;
+        // per channel: history followed by the current block (linear, the history is moved to the front after each block)
+        int m_upStride = 0;
+        int m_evenStride = 0;
+        int m_oddStride = 0;
+        std::vector<FloatType> m_upBuffer;
+        std::vector<FloatType> m_evenBuffer;
+        std::vector<FloatType> m_oddBuffer;
+        // even output samples of the up sampler, per channel
+        std::vector<FloatType> m_work;
+    };
+
+    int m_factor;
+    int m_latency;
+    int m_maxBlockSize;
+    int m_numSamples;
+    std::vector<HalfbandStage> m_stages;
+    // oversampled signal after the first (2x) and second stage (4x)
+    juce::AudioBuffer<FloatType> m_buffer2x;
+    juce::AudioBuffer<FloatType> m_buffer4x;
+};
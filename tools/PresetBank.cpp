@@ -0,0 +1,130 @@
+#include "PresetBank.h"
+
+namespace
+{
+    // "JPBK" in a little endian file
+    const int c_magic = 0x4b42504a;
+}
+
+bool PresetBank::open(const juce::File& bankFile)
+{
+    close();
+    if (!bankFile.existsAsFile())
+        return false;
+    m_map = std::make_unique<juce::MemoryMappedFile>(bankFile, juce::MemoryMappedFile::readOnly);
+    auto fileSize = static_cast<juce::int64>(m_map->getSize());
+    if (m_map->getData() == nullptr || fileSize < 20)
+    {
+        close();
+        return false;
+    }
+
+    // the index is read from the mapped pages without a copy
+    juce::MemoryInputStream stream(m_map->getData(), m_map->getSize(), false);
+    int magic = stream.readInt();
+    int version = stream.readInt();
+    int nrOfPresets = stream.readInt();
+    juce::int64 dataOffset = stream.readInt64();
+    if (magic != c_magic || version < 1 || version > c_version || nrOfPresets < 0 || dataOffset > fileSize)
+    {
+        close();
+        return false;
+    }
+    m_index.reserve(nrOfPresets);
+    for (auto kk = 0; kk < nrOfPresets; ++kk)
+    {
+        Entry entry;
+        entry.name = stream.readString();
+        entry.category = stream.readString();
+        entry.offset = dataOffset + stream.readInt64();
+        entry.size = stream.readInt64();
+        // a truncated or damaged file
+        if (stream.isExhausted() || stream.getPosition() > dataOffset
+            || entry.offset < dataOffset || entry.size < 0 || entry.offset + entry.size > fileSize)
+        {
+            close();
+            return false;
+        }
+        m_names[entry.name] = static_cast<int>(m_index.size());
+        m_index.push_back(entry);
+    }
+    return true;
+}
+
+void PresetBank::close()
+{
+    m_map.reset();
+    m_index.clear();
+    m_names.clear();
+}
+
+int PresetBank::indexOf(const juce::String& name) const
+{
+    auto it = m_names.find(name);
+    return it == m_names.end() ? -1 : it->second;
+}
+
+juce::ValueTree PresetBank::getPreset(int index) const
+{
+    if (!isOpen() || index < 0 || index >= getNrOfPresets())
+        return {};
+    const auto& entry = m_index[index];
+    return juce::ValueTree::readFromData(static_cast<const char*>(m_map->getData()) + entry.offset, static_cast<size_t>(entry.size));
+}
+
+bool PresetBank::write(const juce::File& bankFile, const std::vector<juce::ValueTree>& presets)
+{
+    // one entry per name, sorted as the preset list of the handler
+    std::map<juce::String, const juce::ValueTree*> sorted;
+    for (const auto& preset : presets)
+        if (preset.isValid())
+            sorted[preset.getProperty("presetname").toString()] = &preset;
+
+    juce::MemoryOutputStream index;
+    juce::MemoryOutputStream data;
+    for (const auto& named : sorted)
+    {
+        auto offset = data.getPosition();
+        named.second->writeToStream(data);
+        index.writeString(named.first);
+        index.writeString(named.second->getProperty("category").toString());
+        index.writeInt64(offset);
+        index.writeInt64(data.getPosition() - offset);
+    }
+
+    juce::TemporaryFile temporary(bankFile);
+    {
+        juce::FileOutputStream stream(temporary.getFile());
+        if (!stream.openedOk())
+            return false;
+        juce::int64 headerSize = 20;
+        stream.writeInt(c_magic);
+        stream.writeInt(c_version);
+        stream.writeInt(static_cast<int>(sorted.size()));
+        stream.writeInt64(headerSize + static_cast<juce::int64>(index.getDataSize()));
+        stream.write(index.getData(), index.getDataSize());
+        stream.write(data.getData(), data.getDataSize());
+        stream.flush();
+        if (stream.getStatus().failed())
+            return false;
+    }
+    return temporary.overwriteTargetFileWithTemporary();
+}
+
+int PresetBank::importToFolder(const juce::File& bankFile, const juce::File& folder)
+{
+    PresetBank bank;
+    if (!bank.open(bankFile))
+        return -1;
+    int nrOfPresets = 0;
+    for (auto kk = 0; kk < bank.getNrOfPresets(); ++kk)
+    {
+        auto preset = bank.getPreset(kk);
+        std::unique_ptr<juce::XmlElement> xml(preset.createXml());
+        if (xml == nullptr)
+            continue;
+        if (xml->writeTo(folder.getChildFile(bank.getName(kk) + ".xml")))
+            ++nrOfPresets;
+    }
+    return nrOfPresets;
+}
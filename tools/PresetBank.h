@@ -0,0 +1,69 @@
+/**
+ * @file PresetBank.h
+ * @author J. Bitzer @ Jade HS, BSD Licence
+ * @brief all presets of a plugin in one binary file, memory mapped and decoded preset by preset
+ * Format (little endian, version 1):
+ *   header: int magic "JPBK", int version, int nrOfPresets, int64 offset of the data section
+ *   index: per preset UTF-8 name and category (null terminated), int64 offset (in the data section), int64 size
+ *   data: the presets in the binary ValueTree format (ValueTree::writeToStream)
+ * open only reads the index (names and categories), getPreset decodes one preset from the mapped file.
+ * The file is written to a temporary file first and replaces the old bank (a failed export keeps it).
+ * Usage: write(bankFile, presets) once, then open(bankFile), getName(i), getPreset(indexOf(name))
+ * @version 1.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+// Version 1.0 versioned header and index, memory mapped lazy decoding, XML import/export
+// Version 1.1 removed exportFolder (the handler exports the XML files and the old bank with write)
+
+#pragma once
+#include <map>
+#include <memory>
+#include <vector>
+#include <JuceHeader.h>
+
+class PresetBank
+{
+public:
+    static const int c_version = 1;
+
+    /**
+     * @brief maps bankFile and reads the index, the presets are decoded by getPreset
+     *
+     * @return false if the file does not exist or is no valid bank (of this or an older version)
+     */
+    bool open(const juce::File& bankFile);
+    void close();
+    bool isOpen() const {return m_map != nullptr;};
+
+    int getNrOfPresets() const {return static_cast<int>(m_index.size());};
+    const juce::String& getName(int index) const {return m_index[index].name;};
+    const juce::String& getCategory(int index) const {return m_index[index].category;};
+    // -1 if the bank has no preset of this name
+    int indexOf(const juce::String& name) const;
+    // decodes one preset (invalid if the data are damaged)
+    juce::ValueTree getPreset(int index) const;
+
+    /**
+     * @brief writes a bank of all presets (the key is the property presetname, the last one of a name wins)
+     *
+     * @return true if the new bank replaced bankFile
+     */
+    static bool write(const juce::File& bankFile, const std::vector<juce::ValueTree>& presets);
+    // every preset of the bank as XML file <presetname>.xml in the folder, returns the number of presets or -1
+    static int importToFolder(const juce::File& bankFile, const juce::File& folder);
+
+private:
+    struct Entry
+    {
+        juce::String name;
+        juce::String category;
+        juce::int64 offset;
+        juce::int64 size;
+    };
+    std::unique_ptr<juce::MemoryMappedFile> m_map;
+    std::vector<Entry> m_index;
+    std::map<juce::String, int> m_names;
+};
@@ -0,0 +1,161 @@
+#include "PresetFolderWatcher.h"
+
+#if JUCE_LINUX
+    #include <poll.h>
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+
+PresetFolderWatcher::PresetFolderWatcher()
+:juce::Thread("PresetFolderWatcher")
+{
+}
+
+PresetFolderWatcher::~PresetFolderWatcher()
+{
+    stop();
+}
+
+bool PresetFolderWatcher::start(const juce::File& folder)
+{
+    stop();
+#if JUCE_LINUX
+    m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotify < 0)
+        return false;
+    m_folder = folder;
+    addWatches(folder);
+    return startThread();
+#else
+    juce::ignoreUnused(folder);
+    return false;
+#endif
+}
+
+void PresetFolderWatcher::stop()
+{
+    stopThread(2000);
+    cancelPendingUpdate();
+#if JUCE_LINUX
+    if (m_inotify >= 0)
+        close(m_inotify);
+    m_inotify = -1;
+    m_directories.clear();
+#endif
+}
+
+#if JUCE_LINUX
+void PresetFolderWatcher::addWatch(const juce::File& directory)
+{
+    // IN_CLOSE_WRITE instead of IN_MODIFY: one event per saved file, after the content is complete
+    int watch = inotify_add_watch(m_inotify, directory.getFullPathName().toRawUTF8(),
+        IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_CREATE);
+    if (watch >= 0)
+        m_directories[watch] = directory;
+}
+
+void PresetFolderWatcher::addWatches(const juce::File& directory)
+{
+    addWatch(directory);
+    for (const auto& subdirectory : directory.findChildFiles(juce::File::findDirectories, true))
+        addWatch(subdirectory);
+}
+
+void PresetFolderWatcher::removeWatches(const juce::File& directory)
+{
+    // the watches of a moved directory stay valid, but their paths are wrong
+    for (auto it = m_directories.begin(); it != m_directories.end(); )
+    {
+        if (it->second == directory || it->second.isAChildOf(directory))
+        {
+            inotify_rm_watch(m_inotify, it->first);
+            it = m_directories.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+#endif
+
+void PresetFolderWatcher::run()
+{
+#if JUCE_LINUX
+    alignas(inotify_event) char buffer[4096];
+    while (!threadShouldExit())
+    {
+        pollfd descriptor{m_inotify, POLLIN, 0};
+        if (poll(&descriptor, 1, 200) <= 0)
+            continue;
+        auto length = read(m_inotify, buffer, sizeof(buffer));
+        for (char* position = buffer; length > 0 && position < buffer + length; )
+        {
+            auto event = reinterpret_cast<const inotify_event*>(position);
+            position += sizeof(inotify_event) + event->len;
+            // events were lost (wd -1): the folder stands for all its files, subfolders created
+            // meanwhile are not watched yet
+            if ((event->mask & IN_Q_OVERFLOW) != 0)
+            {
+                addWatches(m_folder);
+                addChangedFile(m_folder);
+                continue;
+            }
+            // the watch was removed (deleted directory or removeWatches)
+            if ((event->mask & IN_IGNORED) != 0)
+            {
+                m_directories.erase(event->wd);
+                continue;
+            }
+            auto directory = m_directories.find(event->wd);
+            if (event->len == 0 || directory == m_directories.end())
+                continue;
+            auto file = directory->second.getChildFile(juce::String::fromUTF8(event->name));
+            if ((event->mask & IN_ISDIR) != 0)
+            {
+                // a new or moved in subfolder (with all its subfolders), its presets are new as well
+                if ((event->mask & (IN_CREATE | IN_MOVED_TO)) != 0)
+                {
+                    addWatches(file);
+                    for (const auto& preset : file.findChildFiles(juce::File::findFiles, true, "*.xml"))
+                        addChangedFile(preset);
+                }
+                // a deleted, moved out or renamed subfolder: the folder path stands for all presets below it
+                // (a rename is followed by IN_MOVED_TO of the new name)
+                else if ((event->mask & (IN_DELETE | IN_MOVED_FROM)) != 0)
+                {
+                    removeWatches(file);
+                    addChangedFile(file);
+                }
+                continue;
+            }
+            // a created file is reported by IN_CLOSE_WRITE, when it is complete
+            if ((event->mask & IN_CREATE) == 0 && file.hasFileExtension("xml"))
+                addChangedFile(file);
+        }
+    }
+#endif
+}
+
+void PresetFolderWatcher::addChangedFile(const juce::File& file)
+{
+    {
+        juce::ScopedLock lock(m_lock);
+        m_changedFiles.insert(file.getFullPathName());
+    }
+    triggerAsyncUpdate();
+}
+
+void PresetFolderWatcher::handleAsyncUpdate()
+{
+    std::set<juce::String> changedPaths;
+    {
+        juce::ScopedLock lock(m_lock);
+        changedPaths.swap(m_changedFiles);
+    }
+    if (onFilesChanged == nullptr || changedPaths.empty())
+        return;
+    juce::StringArray changedFiles;
+    changedFiles.ensureStorageAllocated(static_cast<int>(changedPaths.size()));
+    for (const auto& path : changedPaths)
+        changedFiles.add(path);
+    onFilesChanged(changedFiles);
+}
@@ -0,0 +1,64 @@
+/**
+ * @file PresetFolderWatcher.h
+ * @author J. Bitzer @ Jade HS, BSD Licence
+ * @brief reports XML files that are written, moved or deleted in a folder and its subfolders
+ * (e.g. presets saved by other instances or by sync tools)
+ * Linux: inotify on a background thread (poll with a short timeout to stop), the changed paths are collected
+ * and delivered together on the message thread (AsyncUpdater). Other platforms: start returns false,
+ * the presets change by a rescan only.
+ * A deleted, moved out or renamed subfolder is reported by its own path (it stands for all files below it),
+ * the XML files of a new or moved in subfolder are reported one by one. If the event queue overflows
+ * (events are lost), the watched folder itself is reported and all files below it have to be checked.
+ * Usage: onFilesChanged = ..., start(folder), stop() (or the destructor)
+ * @version 1.2
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+// Version 1.0 inotify (Linux), coalesced notification on the message thread
+// Version 1.1 removed and moved subfolders, recursive watches for moved in folder trees
+// Version 1.2 queue overflow reports the watched folder, the changed paths are collected in a set
+
+#pragma once
+#include <functional>
+#include <map>
+#include <set>
+#include <JuceHeader.h>
+
+class PresetFolderWatcher : private juce::Thread, private juce::AsyncUpdater
+{
+public:
+    PresetFolderWatcher();
+    ~PresetFolderWatcher() override;
+    /**
+     * @brief watches folder and all its subfolders (new subfolders as well)
+     *
+     * @return false if file notifications are not supported on this platform
+     */
+    bool start(const juce::File& folder);
+    void stop();
+    bool isWatching() {return isThreadRunning();};
+
+    // message thread: full paths of the XML files (or removed subfolders, or the watched folder after
+    // a queue overflow) changed since the last call
+    std::function<void(const juce::StringArray& changedFiles)> onFilesChanged;
+
+private:
+    void run() override;
+    void handleAsyncUpdate() override;
+    void addChangedFile(const juce::File& file);
+
+#if JUCE_LINUX
+    void addWatch(const juce::File& directory);
+    // directory and all its subfolders
+    void addWatches(const juce::File& directory);
+    void removeWatches(const juce::File& directory);
+    int m_inotify = -1;
+    juce::File m_folder;
+    // watch descriptor to directory (watcher thread only after start)
+    std::map<int, juce::File> m_directories;
+#endif
+    juce::CriticalSection m_lock;
+    std::set<juce::String> m_changedFiles;
+};
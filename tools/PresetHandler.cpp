@@ -16,6 +16,14 @@ PresetHandler::PresetHandler()
 {
 	m_categoryList.push_back("Unknown"); // default is None
 }
+PresetHandler::~PresetHandler()
+{
+	m_watcher.stop();
+	// waits for the running jobs, they stop after their current file
+	m_cancelScan = true;
+	m_scanPool.reset();
+	cancelPendingUpdate();
+}
 void PresetHandler::addCategory(String newCat)
 {
 	if (hasCategories == false)
@@ -77,6 +85,14 @@ ValueTree PresetHandler::getPreset(String name)
 	if (isKey == 1)
 	{
 		ValueTree vt = m_presetList.at(name);
+		// bank presets are decoded on demand (the category may be changed meanwhile)
+		if (isPresetStub(vt))
+		{
+			ValueTree preset = loadPreset(name);
+			if (preset.isValid())
+				preset.setProperty("category", vt.getProperty("category"), nullptr);
+			return preset;
+		}
 		return vt;
 	}
 	else
@@ -198,6 +214,10 @@ ValueTree PresetHandler::loadPreset(String name)
 	bool wasCreated;
 	File infiledir = getUserPresetsFolder(wasCreated);
 	File infileXML = infiledir.getChildFile(name + ".xml");
+	// the file of an indexed preset is known (also in subfolders)
+	auto it = m_presetList.find(name);
+	if (it != m_presetList.end() && it->second.hasProperty("presetfile"))
+		infileXML = File(it->second.getProperty("presetfile").toString());
 
 	//File settingsFile2("c:\\AudioDev\\init.xml");
 	//XmlDocument settingsDocument(settingsFile2);
@@ -208,6 +228,10 @@ ValueTree PresetHandler::loadPreset(String name)
 		vt = ValueTree::fromXml(*xml);
 		
 	}
+	else if (m_bank.indexOf(name) >= 0)
+	{
+		vt = m_bank.getPreset(m_bank.indexOf(name));
+	}
 	return vt;
 }
 
@@ -225,6 +249,18 @@ int PresetHandler::deletePresetFile(String name)
 	File outfiledir = getUserPresetsFolder(wasCreated);
 	File outfileXML = outfiledir.getChildFile(name + ".xml");
 	outfileXML.deleteFile();
+	// the bank is written again without this preset
+	int index = m_bank.indexOf(name);
+	if (index >= 0)
+	{
+		std::vector<ValueTree> presets;
+		for (auto kk = 0; kk < m_bank.getNrOfPresets(); ++kk)
+			if (kk != index)
+				presets.push_back(m_bank.getPreset(kk));
+		m_bank.close();
+		PresetBank::write(getUserPresetBankFile(), presets);
+		m_bank.open(getUserPresetBankFile());
+	}
 	return 0;
 }
 
@@ -233,18 +269,324 @@ int PresetHandler::loadfromFileAllUserPresets()
 	bool wasCreated;
 	File outfiledir = getUserPresetsFolder(wasCreated);
 	auto files = outfiledir.findChildFiles(File::findFiles, true, "*.xml");
-	if (files.isEmpty() == true)
+	m_bank.open(getUserPresetBankFile());
+	if (files.isEmpty() == true && m_bank.getNrOfPresets() == 0)
 	{
 		addOrChangeCurrentPreset("Init","Unknown");
 	}
 	for (auto oneFile : files)
 	{
-		auto vt = loadPreset(oneFile.getFileNameWithoutExtension());
-		String cat = vt.getProperty("category");
+		auto vt = parsePresetFile(oneFile);
+		if (!vt.isValid())
+			continue;
+		repairCategory(vt);
+		addPreset(vt);
+	}
+	addBankPresets();
+	return files.size() + m_bank.getNrOfPresets();
+}
+
+ValueTree PresetHandler::parsePresetFile(const File& file)
+{
+	// thread safe: every call has its own XmlElement and ValueTree
+	std::unique_ptr<XmlElement> xml(XmlDocument::parse(file));
+	ValueTree vt;
+	if (xml != nullptr)
+		vt = ValueTree::fromXml(*xml);
+	return vt;
+}
+
+void PresetHandler::startLoadingAllUserPresets()
+{
+	if (m_isScanning.load())
+		return;
+	bool wasCreated;
+	m_scanFolder = getUserPresetsFolder(wasCreated);
+	File bankFile = getUserPresetBankFile();
+	File indexFile = getUserPresetIndexFile();
+	m_initPreset = m_vts->copyState();
+
+	// started before the scan, no change gets lost
+	m_watcher.onFilesChanged = [this](const StringArray& changedFiles) {presetFilesChanged(changedFiles); };
+	m_watcher.start(m_scanFolder);
+
+	int nrOfThreads = jlimit(1, g_presetScanMaxThreads, SystemStats::getNumCpus() - 1);
+	// released by handleAsyncUpdate when the scan is finished
+	m_scanPool = std::make_unique<ThreadPool>(nrOfThreads);
+	m_scanResults.assign(nrOfThreads, {});
+	m_isScanning = true;
+
+	// the first job lists the folder and compares with the index,
+	// then nrOfThreads jobs parse every nrOfThreads-th new or changed file
+	m_scanPool->addJob([this, bankFile, indexFile, nrOfThreads]()
+	{
+		m_scanBank = std::make_unique<PresetBank>();
+		m_scanBank->open(bankFile);
+		PresetIndex oldIndex;
+		oldIndex.load(indexFile);
+		m_scanIndex.clear();
+		m_scanChangedFiles.clear();
+		m_scanFiles = m_scanFolder.findChildFiles(File::findFiles, true, "*.xml");
+		for (const auto& file : m_scanFiles)
+		{
+			auto relativePath = file.getRelativePathFrom(m_scanFolder);
+			auto entry = oldIndex.findUnchanged(relativePath, file.getLastModificationTime().toMilliseconds(), file.getSize());
+			if (entry != nullptr)
+				m_scanIndex.set(relativePath, *entry);
+			else
+				m_scanChangedFiles.add(file);
+		}
+		if (m_cancelScan.load())
+			return;
+		m_remainingScanJobs = nrOfThreads;
+		for (auto job = 0; job < nrOfThreads; ++job)
+		{
+			m_scanPool->addJob([this, job, nrOfThreads]()
+			{
+				auto& results = m_scanResults[job];
+				for (auto kk = job; kk < m_scanChangedFiles.size() && !m_cancelScan.load(); kk += nrOfThreads)
+				{
+					const auto& file = m_scanChangedFiles.getReference(kk);
+					auto vt = parsePresetFile(file);
+					if (!vt.isValid())
+						continue;
+					PresetIndex::Entry entry;
+					entry.name = vt.getProperty("presetname").toString();
+					entry.category = vt.getProperty("category").toString();
+					entry.modificationTime = file.getLastModificationTime().toMilliseconds();
+					entry.size = file.getSize();
+					results.push_back({file.getRelativePathFrom(m_scanFolder), entry});
+				}
+				if (--m_remainingScanJobs == 0)
+					triggerAsyncUpdate();
+			});
+		}
+	});
+}
+
+void PresetHandler::handleAsyncUpdate()
+{
+	jassert(m_remainingScanJobs.load() == 0);
+	// the threads are not kept for the session (dozens of instances), the last job has only to return
+	m_scanPool.reset();
+	m_bank = std::move(*m_scanBank);
+	m_scanBank.reset();
+	if (m_scanFiles.isEmpty() && m_bank.getNrOfPresets() == 0)
+	{
+		// same as loadfromFileAllUserPresets, but with the state of the construction (a project may be loaded meanwhile)
+		m_initPreset.setProperty("version", JucePlugin_VersionString, nullptr);
+		m_initPreset.setProperty("presetname", "Init", nullptr);
+		m_initPreset.setProperty("category", "Unknown", nullptr);
+		m_initPreset.setProperty("bank", "User", nullptr);
+		if (!isAlreadyAPreset("Init"))
+		{
+			addPreset(m_initPreset);
+			savePreset(m_initPreset);
+		}
+	}
+	for (auto& results : m_scanResults)
+		for (auto& result : results)
+			m_scanIndex.set(result.first, result.second);
+	// presets added or changed during the scan are newer than their files
+	for (const auto& file : m_scanIndex.getEntries())
+		if (!isAlreadyAPreset(file.second.name))
+			addPreset(createFileStub(m_scanFolder.getChildFile(file.first), file.second));
+	addBankPresets();
+	m_index = std::move(m_scanIndex);
+	m_index.save(getUserPresetIndexFile());
+
+	m_scanFiles.clear();
+	m_scanChangedFiles.clear();
+	m_scanResults.clear();
+	m_initPreset = ValueTree();
+	m_isScanning = false;
+	if (!m_pendingChangedFiles.empty())
+	{
+		StringArray changedFiles;
+		for (const auto& path : m_pendingChangedFiles)
+			changedFiles.add(path);
+		m_pendingChangedFiles.clear();
+		presetFilesChanged(changedFiles);
+		return;
+	}
+	sendSynchronousChangeMessage();
+}
+
+void PresetHandler::presetFilesChanged(const StringArray& changedFiles)
+{
+	if (m_isScanning.load())
+	{
+		m_pendingChangedFiles.insert(changedFiles.begin(), changedFiles.end());
+		return;
+	}
+	bool wasCreated;
+	File folder = getUserPresetsFolder(wasCreated);
+	// a removed or moved subfolder stands for all indexed files below it, an existing folder (the user
+	// folder after an overflow of the watcher) for its files on disk as well; only files that differ
+	// from the index are parsed again
+	std::set<String> changedPaths;
+	for (const auto& path : changedFiles)
+	{
+		File changed(path);
+		if (changed.hasFileExtension("xml") && !changed.isDirectory())
+		{
+			changedPaths.insert(path);
+			continue;
+		}
+		for (const auto& indexed : m_index.getEntries())
+		{
+			auto indexedFile = folder.getChildFile(indexed.first);
+			if (indexedFile.isAChildOf(changed) && m_index.findUnchanged(indexed.first,
+				indexedFile.getLastModificationTime().toMilliseconds(), indexedFile.getSize()) == nullptr)
+				changedPaths.insert(indexedFile.getFullPathName());
+		}
+		if (changed.isDirectory())
+			for (const auto& file : changed.findChildFiles(File::findFiles, true, "*.xml"))
+				if (m_index.findUnchanged(file.getRelativePathFrom(folder), file.getLastModificationTime().toMilliseconds(), file.getSize()) == nullptr)
+					changedPaths.insert(file.getFullPathName());
+	}
+	for (const auto& path : changedPaths)
+	{
+		File file(path);
+		auto relativePath = file.getRelativePathFrom(folder);
+		// the old version of the file is removed first (the preset may have been renamed)
+		auto oldEntry = m_index.find(relativePath);
+		if (oldEntry != nullptr)
+		{
+			// only if the list entry of this name comes from this file (not from another file or the bank)
+			auto it = m_presetList.find(oldEntry->name);
+			if (it != m_presetList.end() && isPresetOfFile(it->second, file, folder))
+				m_presetList.erase(it);
+			m_index.remove(relativePath);
+		}
+		if (!file.existsAsFile())
+			continue;
+		auto vt = parsePresetFile(file);
+		if (!vt.isValid())
+			continue;
+		PresetIndex::Entry entry;
+		entry.name = vt.getProperty("presetname").toString();
+		entry.category = vt.getProperty("category").toString();
+		entry.modificationTime = file.getLastModificationTime().toMilliseconds();
+		entry.size = file.getSize();
+		m_index.set(relativePath, entry);
+		// the file is newer than the preset in the list (e.g. saved by another instance)
+		m_presetList.insert_or_assign(entry.name, createFileStub(file, entry));
+	}
+	// a deleted file may uncover a bank preset
+	addBankPresets();
+	m_index.save(getUserPresetIndexFile());
+	sendSynchronousChangeMessage();
+}
+
+ValueTree PresetHandler::createFileStub(const File& file, const PresetIndex::Entry& entry)
+{
+	ValueTree vt(m_vts->state.getType());
+	vt.setProperty("presetname", entry.name, nullptr);
+	vt.setProperty("category", entry.category, nullptr);
+	vt.setProperty("presetfile", file.getFullPathName(), nullptr);
+	repairCategory(vt);
+	return vt;
+}
+
+bool PresetHandler::isPresetOfFile(const ValueTree& vt, const File& file, const File& folder)
+{
+	if (vt.hasProperty("presetfile"))
+		return File(vt.getProperty("presetfile").toString()) == file;
+	// saved by this instance (savePreset writes <presetname>.xml into the user folder)
+	if (vt.hasProperty("bankstub"))
+		return false;
+	return folder.getChildFile(vt.getProperty("presetname").toString() + ".xml") == file;
+}
+
+File PresetHandler::getUserPresetIndexFile()
+{
+	bool wasCreated;
+	return getUserPresetsFolder(wasCreated).getChildFile(String(JucePlugin_Name) + ".presetindex");
+}
+
+File PresetHandler::getUserPresetBankFile()
+{
+	bool wasCreated;
+	return getUserPresetsFolder(wasCreated).getChildFile(String(JucePlugin_Name) + ".presetbank");
+}
+
+void PresetHandler::addBankPresets()
+{
+	for (auto kk = 0; kk < m_bank.getNrOfPresets(); ++kk)
+	{
+		if (isAlreadyAPreset(m_bank.getName(kk)))
+			continue;
+		ValueTree vt(m_vts->state.getType());
+		vt.setProperty("presetname", m_bank.getName(kk), nullptr);
+		vt.setProperty("category", m_bank.getCategory(kk), nullptr);
+		vt.setProperty("bankstub", true, nullptr);
 		repairCategory(vt);
 		addPreset(vt);
 	}
-	return files.size();
+}
+
+int PresetHandler::exportUserPresetsToBank(bool removeXmlFiles, Array<File>* skippedFiles)
+{
+	// the scan would add the old bank again
+	if (m_isScanning.load())
+		return -1;
+	bool wasCreated;
+	File folder = getUserPresetsFolder(wasCreated);
+	auto files = folder.findChildFiles(File::findFiles, true, "*.xml");
+	std::vector<ValueTree> presets;
+	// bank presets first, the XML files of the same name overwrite them in PresetBank::write
+	for (auto kk = 0; kk < m_bank.getNrOfPresets(); ++kk)
+		presets.push_back(m_bank.getPreset(kk));
+	// the file whose preset is stored under each name (the last one of a name wins)
+	std::map<String, File> exportedFiles;
+	for (auto oneFile : files)
+	{
+		auto vt = parsePresetFile(oneFile);
+		String name = vt.getProperty("presetname").toString();
+		if (!vt.isValid() || name.isEmpty())
+		{
+			if (skippedFiles != nullptr)
+				skippedFiles->add(oneFile);
+			continue;
+		}
+		presets.push_back(vt);
+		auto it = exportedFiles.find(name);
+		if (it != exportedFiles.end() && skippedFiles != nullptr)
+			skippedFiles->add(it->second);
+		exportedFiles[name] = oneFile;
+	}
+
+	// the mapped file is replaced
+	m_bank.close();
+	bool isWritten = PresetBank::write(getUserPresetBankFile(), presets);
+	m_bank.open(getUserPresetBankFile());
+	if (!isWritten)
+		return -1;
+	// only files whose preset is in the written bank, the others keep their data
+	if (removeXmlFiles)
+		for (const auto& exported : exportedFiles)
+		{
+			if (m_bank.indexOf(exported.first) >= 0)
+				exported.second.deleteFile();
+			else if (skippedFiles != nullptr)
+				skippedFiles->add(exported.second);
+		}
+	// the list refers to the new bank and the remaining files (without waiting for the watcher)
+	presetFilesChanged(StringArray(folder.getFullPathName()));
+	return m_bank.getNrOfPresets();
+}
+
+int PresetHandler::importUserPresetsFromBank()
+{
+	if (m_isScanning.load())
+		return -1;
+	bool wasCreated;
+	File folder = getUserPresetsFolder(wasCreated);
+	int nrOfPresets = PresetBank::importToFolder(getUserPresetBankFile(), folder);
+	if (nrOfPresets > 0)
+		presetFilesChanged(StringArray(folder.getFullPathName()));
+	return nrOfPresets;
 }
 
 int PresetHandler::getAllKeys(std::vector<String>& keys, std::vector<String>& presetcats)
@@ -318,6 +660,10 @@ PresetComponent::PresetComponent(PresetHandler& ph)
 	m_saveButton.onClick = [this]() {savePreset(); };
 	addAndMakeVisible(m_saveButton);
 
+	m_bankButton.setButtonText("Bank");
+	m_bankButton.onClick = [this]() {bankButtonClick(); };
+	addAndMakeVisible(m_bankButton);
+
 	// todo: check if could move that to !m_hide
 	int id = 1;
 	for (auto cat : m_presetHandler.m_categoryList)
@@ -333,6 +679,34 @@ PresetComponent::PresetComponent(PresetHandler& ph)
 
 	m_presetCombo.onChange = [this]() {itemchanged(); };
 
+	selectCurrentPreset();
+	m_presetCombo.isTextEditable();
+	m_presetCombo.setEditableText(true);
+	m_presetCombo.setColour(ComboBox::ColourIds::backgroundColourId, juce::Colours::grey);
+
+	addAndMakeVisible(m_presetCombo);
+
+	//itemchanged();
+	m_somethingchanged = false;
+	// the presets may still be loading
+	m_presetHandler.addChangeListener(this);
+}
+
+PresetComponent::~PresetComponent()
+{
+	m_presetHandler.removeChangeListener(this);
+}
+
+void PresetComponent::changeListenerCallback(ChangeBroadcaster* source)
+{
+	ignoreUnused(source);
+	m_presetCombo.clear(NotificationType::dontSendNotification);
+	buildPresetCombo();
+	selectCurrentPreset();
+}
+
+void PresetComponent::selectCurrentPreset()
+{
 	String curPresetName = m_presetHandler.getCurrentPresetName();
 	auto numItems = m_presetCombo.getNumItems();
 	int startItem = 0;
@@ -347,14 +721,6 @@ PresetComponent::PresetComponent(PresetHandler& ph)
 	}
 
 	m_presetCombo.setSelectedItemIndex(startItem, NotificationType::dontSendNotification);
-	m_presetCombo.isTextEditable();
-	m_presetCombo.setEditableText(true);
-	m_presetCombo.setColour(ComboBox::ColourIds::backgroundColourId, juce::Colours::grey);
-
-	addAndMakeVisible(m_presetCombo);
-
-	//itemchanged();
-	m_somethingchanged = false;
 }
 
 void PresetComponent::paint(Graphics & g)
@@ -397,6 +763,7 @@ void PresetComponent::resized()
 	m_nextButton.setBounds(xmidPos + comboWidthHalf + newElementDist/2, 3, newButtonWidth, newElementHeight);
 	m_saveButton.setBounds(xmidPos + comboWidthHalf + 2*newElementDist + newButtonWidth, 3, newButtonWidth, newElementHeight);
 	m_prevButton.setBounds(xmidPos - comboWidthHalf - newElementDist/2 - newButtonWidth, 3, newButtonWidth, newElementHeight);
+	m_bankButton.setBounds(xmidPos + comboWidthHalf + 3*newElementDist + 2*newButtonWidth, 3, newButtonWidth, newElementHeight);
 
 	//m_nextButton.
 
@@ -442,6 +809,29 @@ void PresetComponent::savePreset()
 	m_somethingchanged = false;
 	repaint();
 }
+void PresetComponent::bankButtonClick()
+{
+	PopupMenu menu;
+	menu.addItem(1, "Export user presets to bank");
+	menu.addItem(2, "Export to bank and remove XML files");
+	menu.addItem(3, "Import bank into user folder");
+	menu.showMenuAsync(PopupMenu::Options().withTargetComponent(&m_bankButton), [this](int result)
+	{
+		if (result == 0)
+			return;
+		int nrOfPresets;
+		if (result == 3)
+			nrOfPresets = m_presetHandler.importUserPresetsFromBank();
+		else
+			nrOfPresets = m_presetHandler.exportUserPresetsToBank(result == 2);
+		String message;
+		if (nrOfPresets < 0)
+			message = "Failed (the presets may still be loading).";
+		else
+			message = String(nrOfPresets) + (result == 3 ? " presets imported." : " presets in the bank.");
+		AlertWindow::showMessageBoxAsync(AlertWindow::InfoIcon, "Preset bank", message);
+	});
+}
 void PresetComponent::prevButtonClick()
 {
 	int id = m_presetCombo.getSelectedItemIndex();
@@ -15,6 +15,20 @@
 
 	// Version 1.2.0 18.01.20 JB: added submenus for categories (if provided)
 	// Version 1.2.1 18.09.23 JB: add category changed to prevent empty strings
+	// Version 1.3.0 17.10.26 JB: startLoadingAllUserPresets scans and parses the preset files in parallel on 
+								  a background thread pool, the handler publishes the presets on the message thread
+								  (ChangeBroadcaster, PresetComponent rebuilds its combo box)
+	// Version 1.4.0 17.10.26 JB: optional binary preset bank next to the XML files (tools/PresetBank.h),
+								  only name and category of its presets are kept until one is loaded
+	// Version 1.5.0 17.10.26 JB: persistent preset index (tools/PresetIndex.h), the scan only parses new or
+								  changed files, all presets are loaded on demand; changes of the folder by other
+								  instances are applied incrementally (tools/PresetFolderWatcher.h, Linux)
+	// Version 1.5.1 17.10.26 JB: exportUserPresetsToBank deletes only XML files whose preset is in the bank
+	// Version 1.5.2 17.10.26 JB: the thread pool of the scan is released when the scan is finished
+	// Version 1.5.3 17.10.26 JB: removed subfolders, a changed file only removes its own preset from the list
+	// Version 1.5.4 17.10.26 JB: a reported folder (watcher queue overflow) re-validates all files below it
+								  against the index, the changed paths are collected in sets
+	// Version 1.5.5 17.10.26 JB: bank export and import in the preset component (Bank button), both update the list
 
   ==============================================================================
 */
@@ -37,19 +51,26 @@
 #include <juce_core/juce_core.h>
 #include <juce_data_structures/juce_data_structures.h>
 //*/
+#include <atomic>
 #include <list>
+#include <memory>
+#include <set>
 #include <vector>
 
 #include "../PluginSettings.h"
+#include "PresetBank.h"
+#include "PresetFolderWatcher.h"
+#include "PresetIndex.h"
 const int g_maxNumberOfCategories = 20;
 
-class PresetHandler
+class PresetHandler : public ChangeBroadcaster, private AsyncUpdater
 {
 public:
 //	const std::vector<std::string> Categories;
 
 
 	PresetHandler();
+	~PresetHandler();
 	int setAudioValueTreeState(AudioProcessorValueTreeState* vts);
 	int addPreset(ValueTree& newpreset);
 	int addOrChangeCurrentPreset(String name, String category = "Unknown", String bank = "User");
@@ -66,6 +87,21 @@ public:
 	int loadPresetAndActivate(String name);
 	int deletePresetFile(String name);
 	int loadfromFileAllUserPresets();
+	// same as loadfromFileAllUserPresets without blocking: the files are parsed on up to g_presetScanMaxThreads
+	// background threads, the presets are added on the message thread and a change message is sent
+	void startLoadingAllUserPresets();
+	bool isLoadingPresets() { return m_isScanning.load(); };
+	// the bank is read if it exists, XML files of the same name are newer (saved after the export)
+	File getUserPresetBankFile();
+	// name, category, modification time and size of the XML files (written by the background scan)
+	File getUserPresetIndexFile();
+	// all user presets (XML files and bank) into a new bank, returns the number of presets or -1
+	// removeXmlFiles deletes only the files whose preset is in the new bank, skippedFiles (if given) receives
+	// the files that are not in it (no valid preset or a later file of the same name)
+	int exportUserPresetsToBank(bool removeXmlFiles = false, Array<File>* skippedFiles = nullptr);
+	// every preset of the bank as XML file into the user folder, returns the number of presets or -1
+	// (both update the preset list)
+	int importUserPresetsFromBank();
 	int getNrOfPresets() { return m_presetList.size(); };
 	int getAllKeys(std::vector<String>& keys, std::vector<String>& presetcats);
 
@@ -109,6 +145,42 @@ private:
 	String m_curPresetName;
 	bool hasCategories;
 
+	// background scan, the results are only touched by the message thread after all jobs are finished
+	static ValueTree parsePresetFile(const File& file);
+	void handleAsyncUpdate() override;
+	// exists only while a scan is running
+	std::unique_ptr<ThreadPool> m_scanPool;
+	std::atomic<bool> m_cancelScan{false};
+	std::atomic<bool> m_isScanning{false};
+	std::atomic<int> m_remainingScanJobs{0};
+	File m_scanFolder;
+	Array<File> m_scanFiles;
+	// the files without a valid entry in the index are parsed
+	Array<File> m_scanChangedFiles;
+	PresetIndex m_scanIndex;
+	// one result list per job (no locking while parsing), relative path and index entry
+	std::vector<std::vector<std::pair<String, PresetIndex::Entry>>> m_scanResults;
+	// the default state, saved as Init if there are no presets
+	ValueTree m_initPreset;
+	// opened by the scan, moved to m_bank on the message thread
+	std::unique_ptr<PresetBank> m_scanBank;
+
+	PresetBank m_bank;
+	// name and category of the bank presets, the XML files and existing presets win
+	void addBankPresets();
+	// presets of the index or the bank are stubs with name and category until they are loaded
+	ValueTree createFileStub(const File& file, const PresetIndex::Entry& entry);
+	bool isPresetStub(const ValueTree& vt) { return vt.hasProperty("bankstub") || vt.hasProperty("presetfile"); };
+	// true if the list entry vt was read from (or saved to) file
+	static bool isPresetOfFile(const ValueTree& vt, const File& file, const File& folder);
+
+	// the index of the XML files, kept up to date by the watcher
+	PresetIndex m_index;
+	PresetFolderWatcher m_watcher;
+	// changes during the scan are applied afterwards
+	std::set<String> m_pendingChangedFiles;
+	void presetFilesChanged(const StringArray& changedFiles);
+
 	void repairCategory(ValueTree& vt)
 	{
 		String category = vt.getProperty("category");
@@ -127,16 +199,19 @@ private:
 
 };
 
-class PresetComponent : public Component
+class PresetComponent : public Component, public ChangeListener
 {
 public:
 	PresetComponent(PresetHandler&);
+	~PresetComponent();
 	void paint(Graphics& g) override;
 	void resized() override;
 	void setSomethingChanged() {
 		m_somethingchanged = true; repaint();
 	};
 	void setNoCategory();
+	// the presets of the handler changed (e.g. the background scan is finished)
+	void changeListenerCallback(ChangeBroadcaster* source) override;
 
 private:
 	ComboBox m_presetCombo;
@@ -144,6 +219,7 @@ private:
 	TextButton m_nextButton;
 	TextButton m_prevButton;
 	TextButton m_saveButton;
+	TextButton m_bankButton;
 	ComboBox m_categoriesCombo;
 
 	PresetHandler& m_presetHandler;
@@ -153,10 +229,13 @@ private:
 	void itemchanged();
 	void categorychanged();
 	void savePreset();
+	// export / import menu of the user preset bank
+	void bankButtonClick();
 
 	String m_oldcatname;
 	bool m_somethingchanged;
 	bool m_hidecategory;
 
 	void buildPresetCombo();
+	void selectCurrentPreset();
 };
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "PresetIndex.h"
+
+bool PresetIndex::load(const juce::File& indexFile)
+{
+    clear();
+    juce::MemoryBlock data;
+    if (!indexFile.loadFileAsData(data))
+        return false;
+    auto index = juce::ValueTree::readFromData(data.getData(), data.getSize());
+    if (!index.hasType("PresetIndex") || static_cast<int>(index.getProperty("version")) != c_version)
+        return false;
+    for (const auto& file : index)
+    {
+        Entry entry;
+        entry.name = file.getProperty("name").toString();
+        entry.category = file.getProperty("category").toString();
+        entry.modificationTime = static_cast<juce::int64>(file.getProperty("time"));
+        entry.size = static_cast<juce::int64>(file.getProperty("size"));
+        m_entries[file.getProperty("path").toString()] = entry;
+    }
+    return true;
+}
+
+bool PresetIndex::save(const juce::File& indexFile) const
+{
+    juce::ValueTree index("PresetIndex");
+    index.setProperty("version", c_version, nullptr);
+    for (const auto& file : m_entries)
+    {
+        juce::ValueTree entry("File");
+        entry.setProperty("path", file.first, nullptr);
+        entry.setProperty("name", file.second.name, nullptr);
+        entry.setProperty("category", file.second.category, nullptr);
+        entry.setProperty("time", file.second.modificationTime, nullptr);
+        entry.setProperty("size", file.second.size, nullptr);
+        index.appendChild(entry, nullptr);
+    }
+
+    juce::TemporaryFile temporary(indexFile);
+    {
+        juce::FileOutputStream stream(temporary.getFile());
+        if (!stream.openedOk())
+            return false;
+        index.writeToStream(stream);
+        stream.flush();
+        if (stream.getStatus().failed())
+            return false;
+    }
+    return temporary.overwriteTargetFileWithTemporary();
+}
+
+const PresetIndex::Entry* PresetIndex::findUnchanged(const juce::String& relativePath, juce::int64 modificationTime, juce::int64 size) const
+{
+    auto entry = find(relativePath);
+    if (entry == nullptr || entry->modificationTime != modificationTime || entry->size != size)
+        return nullptr;
+    return entry;
+}
+
+const PresetIndex::Entry* PresetIndex::find(const juce::String& relativePath) const
+{
+    auto it = m_entries.find(relativePath);
+    return it == m_entries.end() ? nullptr : &it->second;
+}
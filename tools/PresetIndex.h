@@ -0,0 +1,48 @@
+/**
+ * @file PresetIndex.h
+ * @author J. Bitzer @ Jade HS, BSD Licence
+ * @brief persistent index of the preset files in a folder: name and category per file,
+ * keyed by the relative path and valid as long as modification time and size are unchanged
+ * A rescan only parses the files without a valid entry (new or changed by other instances or sync tools).
+ * Saved in the binary ValueTree format (through a temporary file, several instances may write it).
+ * Usage: load(indexFile), findUnchanged(path, time, size) per file, set() for parsed ones, save(indexFile)
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+// Version 1.0 path, modification time and size per preset file
+
+#pragma once
+#include <map>
+#include <JuceHeader.h>
+
+class PresetIndex
+{
+public:
+    static const int c_version = 1;
+
+    struct Entry
+    {
+        juce::String name;
+        juce::String category;
+        juce::int64 modificationTime = 0;
+        juce::int64 size = 0;
+    };
+
+    // false if the file does not exist or has another version (the index starts empty)
+    bool load(const juce::File& indexFile);
+    bool save(const juce::File& indexFile) const;
+    void clear() {m_entries.clear();};
+
+    // the entry of the file if modification time (ms) and size are the indexed ones, nullptr otherwise
+    const Entry* findUnchanged(const juce::String& relativePath, juce::int64 modificationTime, juce::int64 size) const;
+    const Entry* find(const juce::String& relativePath) const;
+    void set(const juce::String& relativePath, const Entry& entry) {m_entries[relativePath] = entry;};
+    void remove(const juce::String& relativePath) {m_entries.erase(relativePath);};
+    const std::map<juce::String, Entry>& getEntries() const {return m_entries;};
+
+private:
+    std::map<juce::String, Entry> m_entries;
+};
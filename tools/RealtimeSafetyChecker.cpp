@@ -0,0 +1,258 @@
+#include "RealtimeSafetyChecker.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if JADE_REALTIME_CHECK && (defined(__linux__) || defined(__APPLE__))
+    #include <execinfo.h>
+    #include <unistd.h>
+    #define JADE_REALTIME_HAS_BACKTRACE 1
+#endif
+#if JADE_REALTIME_CHECK && defined(__linux__) && defined(__GLIBC__)
+    #include <dlfcn.h>
+    #include <errno.h>
+    #include <pthread.h>
+    #include <time.h>
+    #define JADE_REALTIME_INTERPOSE 1
+#endif
+
+namespace
+{
+    // plain ints with constant initialization, no allocation on first access in the executable
+    thread_local int t_realtimeDepth = 0;
+    thread_local int t_suspendDepth = 0;
+    std::atomic<int> g_nrOfViolations{0};
+    std::atomic<bool> g_abortOnViolation{false};
+
+    inline void check(const char* what)
+    {
+        if (t_realtimeDepth > 0 && t_suspendDepth == 0)
+            jade::RealtimeSafetyChecker::reportViolation(what);
+    }
+
+#if JADE_REALTIME_HAS_BACKTRACE
+    // the first backtrace call loads libgcc (allocates), therefore it is called once at startup
+    struct BacktraceWarmUp
+    {
+        BacktraceWarmUp()
+        {
+            void* frames[4];
+            backtrace(frames, 4);
+        }
+    } g_backtraceWarmUp;
+#endif
+}
+
+namespace jade
+{
+RealtimeSafetyChecker::ScopedRealtime::ScopedRealtime()
+{
+    ++t_realtimeDepth;
+}
+RealtimeSafetyChecker::ScopedRealtime::~ScopedRealtime()
+{
+    --t_realtimeDepth;
+}
+RealtimeSafetyChecker::ScopedSuspend::ScopedSuspend()
+{
+    ++t_suspendDepth;
+}
+RealtimeSafetyChecker::ScopedSuspend::~ScopedSuspend()
+{
+    --t_suspendDepth;
+}
+bool RealtimeSafetyChecker::isRealtimeThread()
+{
+    return t_realtimeDepth > 0;
+}
+int RealtimeSafetyChecker::getNrOfViolations()
+{
+    return g_nrOfViolations;
+}
+void RealtimeSafetyChecker::resetViolations()
+{
+    g_nrOfViolations = 0;
+}
+void RealtimeSafetyChecker::setAbortOnViolation(bool abortOnViolation)
+{
+    g_abortOnViolation = abortOnViolation;
+}
+void RealtimeSafetyChecker::reportViolation(const char* what)
+{
+    // the report itself must not be checked (and must not allocate if possible)
+    ScopedSuspend suspend;
+    ++g_nrOfViolations;
+#if JADE_REALTIME_HAS_BACKTRACE
+    const char header[] = "RealtimeSafetyChecker: ";
+    const char footer[] = " on the realtime thread\n";
+    ssize_t written = write(STDERR_FILENO, header, sizeof(header) - 1);
+    written = write(STDERR_FILENO, what, strlen(what));
+    written = write(STDERR_FILENO, footer, sizeof(footer) - 1);
+    (void) written;
+    void* frames[64];
+    int nrOfFrames = backtrace(frames, 64);
+    // skip this function and the interceptor
+    backtrace_symbols_fd(frames + 2, nrOfFrames > 2 ? nrOfFrames - 2 : 0, STDERR_FILENO);
+#else
+    fprintf(stderr, "RealtimeSafetyChecker: %s on the realtime thread\n", what);
+#endif
+    if (g_abortOnViolation)
+        std::abort();
+}
+}
+
+#if JADE_REALTIME_INTERPOSE
+// glibc: malloc and friends are replaced (this covers new/delete and all C allocations)
+extern "C"
+{
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t number, size_t size);
+    void* __libc_realloc(void* pointer, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void* pointer);
+
+    void* malloc(size_t size)
+    {
+        check("malloc");
+        return __libc_malloc(size);
+    }
+    void* calloc(size_t number, size_t size)
+    {
+        check("calloc");
+        return __libc_calloc(number, size);
+    }
+    void* realloc(void* pointer, size_t size)
+    {
+        check("realloc");
+        return __libc_realloc(pointer, size);
+    }
+    void* aligned_alloc(size_t alignment, size_t size)
+    {
+        check("aligned_alloc");
+        return __libc_memalign(alignment, size);
+    }
+    void* memalign(size_t alignment, size_t size)
+    {
+        check("memalign");
+        return __libc_memalign(alignment, size);
+    }
+    int posix_memalign(void** pointer, size_t alignment, size_t size)
+    {
+        check("posix_memalign");
+        *pointer = __libc_memalign(alignment, size);
+        return *pointer != nullptr ? 0 : ENOMEM;
+    }
+    void free(void* pointer)
+    {
+        if (pointer != nullptr)
+            check("free");
+        __libc_free(pointer);
+    }
+}
+
+namespace
+{
+    // the next definition of a function (libc / libpthread), resolved at startup (dlsym can allocate)
+    template <typename Function>
+    Function getNext(Function& next, const char* name)
+    {
+        if (next == nullptr)
+            next = reinterpret_cast<Function>(dlsym(RTLD_NEXT, name));
+        return next;
+    }
+    int (*g_nextMutexLock)(pthread_mutex_t*) = nullptr;
+    int (*g_nextCondWait)(pthread_cond_t*, pthread_mutex_t*) = nullptr;
+    int (*g_nextCondTimedWait)(pthread_cond_t*, pthread_mutex_t*, const struct timespec*) = nullptr;
+    int (*g_nextNanoSleep)(const struct timespec*, struct timespec*) = nullptr;
+    int (*g_nextUSleep)(useconds_t) = nullptr;
+    unsigned int (*g_nextSleep)(unsigned int) = nullptr;
+
+    struct ResolveAtStartup
+    {
+        ResolveAtStartup()
+        {
+            getNext(g_nextMutexLock, "pthread_mutex_lock");
+            getNext(g_nextCondWait, "pthread_cond_wait");
+            getNext(g_nextCondTimedWait, "pthread_cond_timedwait");
+            getNext(g_nextNanoSleep, "nanosleep");
+            getNext(g_nextUSleep, "usleep");
+            getNext(g_nextSleep, "sleep");
+        }
+    } g_resolveAtStartup;
+}
+
+// locks and blocking calls (pthread_mutex_trylock is fine and not intercepted)
+extern "C"
+{
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        check("pthread_mutex_lock");
+        return getNext(g_nextMutexLock, "pthread_mutex_lock")(mutex);
+    }
+    int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+    {
+        check("pthread_cond_wait");
+        return getNext(g_nextCondWait, "pthread_cond_wait")(condition, mutex);
+    }
+    int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const struct timespec* time)
+    {
+        check("pthread_cond_timedwait");
+        return getNext(g_nextCondTimedWait, "pthread_cond_timedwait")(condition, mutex, time);
+    }
+    int nanosleep(const struct timespec* time, struct timespec* remaining)
+    {
+        check("nanosleep");
+        return getNext(g_nextNanoSleep, "nanosleep")(time, remaining);
+    }
+    int usleep(useconds_t time)
+    {
+        check("usleep");
+        return getNext(g_nextUSleep, "usleep")(time);
+    }
+    unsigned int sleep(unsigned int time)
+    {
+        check("sleep");
+        return getNext(g_nextSleep, "sleep")(time);
+    }
+}
+
+#elif JADE_REALTIME_CHECK
+// other platforms: only new and delete are checked
+void* operator new(std::size_t size)
+{
+    check("operator new");
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size)
+{
+    check("operator new[]");
+    if (void* pointer = std::malloc(size == 0 ? 1 : size))
+        return pointer;
+    throw std::bad_alloc();
+}
+void operator delete(void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        check("operator delete");
+    std::free(pointer);
+}
+void operator delete[](void* pointer) noexcept
+{
+    if (pointer != nullptr)
+        check("operator delete[]");
+    std::free(pointer);
+}
+void operator delete(void* pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+    operator delete[](pointer);
+}
+#endif
@@ -0,0 +1,67 @@
+/**
+ * @file RealtimeSafetyChecker.h
+ * @author J. Bitzer @ Jade HS, BSD Licence
+ * @brief debug/test mode to find heap allocations, locks and blocking calls on the audio thread
+ * Compiled in with JADE_REALTIME_CHECK (e.g. add_compile_definitions(JADE_REALTIME_CHECK) in CMakeLists.txt),
+ * otherwise JADE_REALTIME_SCOPE is empty and nothing is replaced.
+ * Put JADE_REALTIME_SCOPE at the start of processBlock. Every malloc/free (also new/delete),
+ * pthread mutex lock, condition wait and sleep of this thread inside the scope is reported
+ * with its stack on stderr (and aborts, if setAbortOnViolation(true)).
+ * On Linux (glibc) malloc, pthread and sleep calls are intercepted by symbol interposition, this works
+ * if the code is linked into the executable (Standalone, testers, batch tools), not for a plugin
+ * loaded by a host. On other platforms only new/delete are checked (stack on macOS only).
+ * @version 1.0
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+// Version 1.0 allocations, mutex locks, condition waits and sleeps
+
+#pragma once
+
+namespace jade
+{
+class RealtimeSafetyChecker
+{
+public:
+    /**
+     * @brief marks the current thread as realtime thread for the lifetime of the object (can be nested)
+     *
+     */
+    class ScopedRealtime
+    {
+    public:
+        ScopedRealtime();
+        ~ScopedRealtime();
+        ScopedRealtime(const ScopedRealtime&) = delete;
+        ScopedRealtime& operator=(const ScopedRealtime&) = delete;
+    };
+    /**
+     * @brief suspends the check in a realtime scope, for calls that are known to be fine (e.g. logging in debug builds)
+     *
+     */
+    class ScopedSuspend
+    {
+    public:
+        ScopedSuspend();
+        ~ScopedSuspend();
+        ScopedSuspend(const ScopedSuspend&) = delete;
+        ScopedSuspend& operator=(const ScopedSuspend&) = delete;
+    };
+
+    static bool isRealtimeThread();
+    // number of violations of all threads since the start (or the last resetViolations)
+    static int getNrOfViolations();
+    static void resetViolations();
+    static void setAbortOnViolation(bool abortOnViolation);
+    // called by the interceptors, what has to be a string literal
+    static void reportViolation(const char* what);
+};
+}
+
+#if JADE_REALTIME_CHECK
+    #define JADE_REALTIME_SCOPE jade::RealtimeSafetyChecker::ScopedRealtime jadeRealtimeScope
+#else
+    #define JADE_REALTIME_SCOPE
+#endif
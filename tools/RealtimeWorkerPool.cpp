@@ -0,0 +1,198 @@
+#include "RealtimeWorkerPool.h"
+
+#include <chrono>
+
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#elif defined(__APPLE__)
+    #include <dispatch/dispatch.h>
+    #include <mach/mach.h>
+    #include <mach/mach_time.h>
+    #include <mach/thread_policy.h>
+    #include <pthread.h>
+#else
+    #include <semaphore.h>
+    #include <pthread.h>
+    #include <sched.h>
+    #include <cerrno>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #include <immintrin.h>
+    #define JADE_CPU_PAUSE() _mm_pause()
+#elif defined(__aarch64__) && !defined(_MSC_VER)
+    #define JADE_CPU_PAUSE() __asm__ __volatile__("yield")
+#else
+    #define JADE_CPU_PAUSE()
+#endif
+
+namespace
+{
+    const auto c_spinTime = std::chrono::microseconds(50); // busy wait after a task before a worker waits on the semaphore
+    const int c_nrOfSpinsPerClockRead = 64;
+    const double c_realtimePriority = 0.5; // position in the SCHED_FIFO priority range (Linux), like the default of JUCE realtime threads
+    const double c_computationShare = 0.5; // share of the callback period a worker may compute without preemption (macOS)
+
+    inline uint32_t getGeneration(uint64_t nextTask) {return static_cast<uint32_t>(nextTask >> 32);}
+    inline uint32_t getIndex(uint64_t nextTask) {return static_cast<uint32_t>(nextTask);}
+}
+
+namespace jade
+{
+// counting semaphore, post does not lock (it enters the kernel only if a thread waits)
+struct RealtimeWorkerPool::Semaphore
+{
+#if defined(_WIN32)
+    Semaphore() {m_handle = CreateSemaphoreW(nullptr, 0, 0x7fffffff, nullptr);}
+    ~Semaphore() {CloseHandle(m_handle);}
+    void post(int count) {ReleaseSemaphore(m_handle, count, nullptr);}
+    void wait() {WaitForSingleObject(m_handle, INFINITE);}
+    HANDLE m_handle;
+#elif defined(__APPLE__)
+    Semaphore() {m_semaphore = dispatch_semaphore_create(0);}
+    ~Semaphore() {dispatch_release(m_semaphore);}
+    void post(int count) {for (auto kk = 0; kk < count; ++kk) dispatch_semaphore_signal(m_semaphore);}
+    void wait() {dispatch_semaphore_wait(m_semaphore, DISPATCH_TIME_FOREVER);}
+    dispatch_semaphore_t m_semaphore;
+#else
+    Semaphore() {sem_init(&m_semaphore, 0, 0);}
+    ~Semaphore() {sem_destroy(&m_semaphore);}
+    void post(int count) {for (auto kk = 0; kk < count; ++kk) sem_post(&m_semaphore);}
+    void wait() {while (sem_wait(&m_semaphore) != 0 && errno == EINTR) {}}
+    sem_t m_semaphore;
+#endif
+};
+
+RealtimeWorkerPool::RealtimeWorkerPool(int nrOfThreads, double callbackPeriod_s)
+:m_callbackPeriod_s(callbackPeriod_s),
+m_semaphore(std::make_unique<Semaphore>())
+{
+    m_threads.reserve(nrOfThreads);
+    for (auto kk = 0; kk < nrOfThreads; ++kk)
+        m_threads.emplace_back([this]() {workerLoop();});
+}
+
+RealtimeWorkerPool::~RealtimeWorkerPool()
+{
+    m_isRunning = false;
+    // every worker waits at most once more (see waitForWork)
+    m_semaphore->post(static_cast<int>(m_threads.size()));
+    for (auto& thread : m_threads)
+        thread.join();
+}
+
+void RealtimeWorkerPool::run(int nrOfTasks, void (*function)(void*, int), void* context)
+{
+    if (nrOfTasks <= 0)
+        return;
+    // the last generation is finished, no worker reads these until the new generation is published
+    m_function.store(function, std::memory_order_relaxed);
+    m_context.store(context, std::memory_order_relaxed);
+    m_nrOfTasks.store(nrOfTasks, std::memory_order_relaxed);
+    m_nrOfFinishedTasks.store(0, std::memory_order_relaxed);
+    uint32_t generation = getGeneration(m_nextTask.load(std::memory_order_relaxed)) + 1;
+    m_nextTask.store(static_cast<uint64_t>(generation) << 32, std::memory_order_seq_cst);
+    // after the new generation is published a waiting worker is either counted here or sees it (waitForWork)
+    int nrOfWaitingWorkers = m_nrOfWaitingWorkers.exchange(0, std::memory_order_seq_cst);
+    if (nrOfWaitingWorkers > 0)
+        m_semaphore->post(nrOfWaitingWorkers);
+
+    processTasks(generation);
+    // only tasks that are already processed by a worker are left
+    while (m_nrOfFinishedTasks.load(std::memory_order_acquire) < nrOfTasks)
+        JADE_CPU_PAUSE();
+}
+
+void RealtimeWorkerPool::processTasks(uint32_t generation)
+{
+    uint64_t nextTask = m_nextTask.load(std::memory_order_acquire);
+    while (true)
+    {
+        // parameters of another generation are only read if the claim fails anyway
+        int nrOfTasks = m_nrOfTasks.load(std::memory_order_relaxed);
+        if (getGeneration(nextTask) != generation || getIndex(nextTask) >= static_cast<uint32_t>(nrOfTasks))
+            return;
+        if (!m_nextTask.compare_exchange_weak(nextTask, nextTask + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+            continue;
+        // the task is claimed, its generation can not end before it is finished
+        auto function = m_function.load(std::memory_order_relaxed);
+        function(m_context.load(std::memory_order_relaxed), static_cast<int>(getIndex(nextTask)));
+        m_nrOfFinishedTasks.fetch_add(1, std::memory_order_release);
+        nextTask = m_nextTask.load(std::memory_order_acquire);
+    }
+}
+
+bool RealtimeWorkerPool::setRealtimePriority()
+{
+#if defined(_WIN32)
+    return SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL) != 0;
+#elif defined(__APPLE__)
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    double ticksPerSecond = 1e9 * timebase.denom / timebase.numer;
+    thread_time_constraint_policy_data_t policy;
+    policy.period = static_cast<uint32_t>(m_callbackPeriod_s * ticksPerSecond);
+    policy.computation = static_cast<uint32_t>(c_computationShare * m_callbackPeriod_s * ticksPerSecond);
+    policy.constraint = policy.period;
+    policy.preemptible = true;
+    return thread_policy_set(pthread_mach_thread_np(pthread_self()), THREAD_TIME_CONSTRAINT_POLICY,
+        reinterpret_cast<thread_policy_t>(&policy), THREAD_TIME_CONSTRAINT_POLICY_COUNT) == KERN_SUCCESS;
+#else
+    int minPriority = sched_get_priority_min(SCHED_FIFO);
+    int maxPriority = sched_get_priority_max(SCHED_FIFO);
+    sched_param param{};
+    param.sched_priority = minPriority + static_cast<int>(c_realtimePriority * (maxPriority - minPriority));
+    // fails with EPERM without rtprio permission, the worker keeps the default priority
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+#endif
+}
+
+void RealtimeWorkerPool::workerLoop()
+{
+    if (setRealtimePriority())
+        m_nrOfRealtimeThreads.fetch_add(1);
+    uint32_t lastGeneration = getGeneration(m_nextTask.load(std::memory_order_acquire));
+    auto lastWork = std::chrono::steady_clock::now();
+    int nrOfSpins = 0;
+    while (m_isRunning.load(std::memory_order_relaxed))
+    {
+        uint32_t generation = getGeneration(m_nextTask.load(std::memory_order_acquire));
+        if (generation != lastGeneration)
+        {
+            lastGeneration = generation;
+            processTasks(generation);
+            lastWork = std::chrono::steady_clock::now();
+            nrOfSpins = 0;
+        }
+        else if (++nrOfSpins % c_nrOfSpinsPerClockRead != 0 || std::chrono::steady_clock::now() - lastWork < c_spinTime)
+        {
+            JADE_CPU_PAUSE();
+        }
+        else
+        {
+            waitForWork(lastGeneration);
+            lastWork = std::chrono::steady_clock::now();
+            nrOfSpins = 0;
+        }
+    }
+}
+
+void RealtimeWorkerPool::waitForWork(uint32_t lastGeneration)
+{
+    m_nrOfWaitingWorkers.fetch_add(1, std::memory_order_seq_cst);
+    bool isNewGeneration = getGeneration(m_nextTask.load(std::memory_order_seq_cst)) != lastGeneration;
+    if (isNewGeneration || !m_isRunning.load(std::memory_order_seq_cst))
+    {
+        // leave without waiting if the count was not taken by run yet (the posts are interchangeable
+        // between the workers, a count taken by run is matched by one post)
+        int nrOfWaitingWorkers = m_nrOfWaitingWorkers.load(std::memory_order_relaxed);
+        while (nrOfWaitingWorkers > 0)
+            if (m_nrOfWaitingWorkers.compare_exchange_weak(nrOfWaitingWorkers, nrOfWaitingWorkers - 1, std::memory_order_seq_cst))
+                return;
+    }
+    m_semaphore->wait();
+}
+}
@@ -0,0 +1,104 @@
+/**
+ * @file RealtimeWorkerPool.h
+ * @author J. Bitzer @ Jade HS, BSD Licence
+ * @brief small pool of worker threads to split the work of one audio callback (e.g. channel groups)
+ * run(nrOfTasks, task) calls task(index) for all indices on the workers and on the calling (audio)
+ * thread and returns when all tasks are finished. run does not allocate, lock or wait on the OS:
+ * the tasks are claimed with a lock-free counter, the calling thread claims tasks as well, therefore
+ * it never waits for a worker that has not started (at worst it does all tasks itself) and only
+ * spins on tasks a worker is already processing.
+ * After a task a worker spins for some microseconds (tasks of the same callback) and then waits on a
+ * semaphore, it uses no CPU between callbacks. run posts the semaphore once per waiting worker
+ * (one atomic exchange, no lock, no system call if all workers are still spinning); a worker that
+ * wakes up late misses the tasks, the calling thread has already done them.
+ * Wake-up cost: callbacks are usually longer than the spin time, therefore the workers sleep between
+ * callbacks and every run pays one post per worker (sem_post / futex wake, about 1-5 us on the audio
+ * thread) and the workers start some 5-50 us later (scheduler latency). Tasks of a short callback
+ * are mostly done by the audio thread itself; the pool pays off for callbacks of several 100 us.
+ * The workers run with realtime priority (SCHED_FIFO on Linux if permitted (rtprio limit),
+ * time critical on Windows, time constraint policy with the callback period on macOS), otherwise a
+ * preempted worker would delay the audio thread that waits for its claimed task.
+ * Only one thread may call run at a time (one pool per processor instance).
+ * @version 1.2
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+// Version 1.0 lock-free task counter, spin / yield / sleep workers
+// Version 1.1 idle workers wait on a semaphore posted by run, the spinning is limited to microseconds
+// Version 1.2 realtime priority of the workers, documented wake-up cost
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace jade
+{
+class RealtimeWorkerPool
+{
+public:
+    /**
+     * @brief starts nrOfThreads worker threads with realtime priority (not realtime safe)
+     *
+     * @param nrOfThreads number of workers, the calling thread of run is an additional one
+     * @param callbackPeriod_s time between two calls of run (the realtime policy of macOS is based on it)
+     */
+    RealtimeWorkerPool(int nrOfThreads, double callbackPeriod_s);
+    ~RealtimeWorkerPool();
+    RealtimeWorkerPool(const RealtimeWorkerPool&) = delete;
+    RealtimeWorkerPool& operator=(const RealtimeWorkerPool&) = delete;
+
+    int getNrOfThreads() const {return static_cast<int>(m_threads.size());};
+    double getCallbackPeriod() const {return m_callbackPeriod_s;};
+    // number of workers that got realtime priority (0 if the user has no rtprio permission on Linux)
+    int getNrOfRealtimeThreads() const {return m_nrOfRealtimeThreads.load();};
+    /**
+     * @brief calls task(index) for index = 0 ... nrOfTasks-1 in parallel and returns when all are finished
+     * (realtime safe, task is called by reference and is not copied)
+     *
+     * @param nrOfTasks
+     * @param task callable with one int argument
+     */
+    template <typename Task>
+    void run(int nrOfTasks, Task& task)
+    {
+        run(nrOfTasks, &callTask<Task>, &task);
+    }
+    void run(int nrOfTasks, void (*function)(void*, int), void* context);
+
+private:
+    template <typename Task>
+    static void callTask(void* context, int index)
+    {
+        (*static_cast<Task*>(context))(index);
+    }
+    // claims and processes tasks of generation until there are none left
+    void processTasks(uint32_t generation);
+    void workerLoop();
+    // gives the calling worker thread realtime priority, returns false if not permitted
+    bool setRealtimePriority();
+    // waits until run posts a new generation (or the pool is destroyed)
+    void waitForWork(uint32_t lastGeneration);
+    // semaphore of the platform (defined in the cpp file)
+    struct Semaphore;
+
+    // generation (upper 32 bit) and index of the next unclaimed task (lower 32 bit), a task can
+    // only be claimed in its own generation
+    std::atomic<uint64_t> m_nextTask{0};
+    std::atomic<void (*)(void*, int)> m_function{nullptr};
+    std::atomic<void*> m_context{nullptr};
+    std::atomic<int> m_nrOfTasks{0};
+    std::atomic<int> m_nrOfFinishedTasks{0};
+    std::atomic<bool> m_isRunning{true};
+    // workers that announced to wait on the semaphore, run takes them all with one exchange
+    std::atomic<int> m_nrOfWaitingWorkers{0};
+    std::atomic<int> m_nrOfRealtimeThreads{0};
+    double m_callbackPeriod_s;
+    std::unique_ptr<Semaphore> m_semaphore;
+    std::vector<std::thread> m_threads;
+};
+}
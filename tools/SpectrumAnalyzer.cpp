@@ -0,0 +1,118 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cstring>
+#include "SpectrumAnalyzer.h"
+
+namespace
+{
+    // the FIFOs hold the samples of some GUI frames (also at 192 kHz)
+    const int c_fifoFrames = 4;
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer()
+:m_fftSize(g_analyzerFFTSize), m_fft(static_cast<int>(log2(g_analyzerFFTSize) + 0.5))
+{
+    jassert(juce::isPowerOfTwo(m_fftSize));
+    // periodic Hann, scaled to 0 dB for a full scale sine
+    m_window.resize(m_fftSize);
+    for (auto kk = 0; kk < m_fftSize; ++kk)
+        m_window[kk] = static_cast<float>(2.0 / m_fftSize * (1.0 - cos(2.0 * M_PI * kk / m_fftSize)));
+
+    int nrOfBins = m_fftSize / 2 + 1;
+    for (auto signal = 0; signal < NrOfSignals; ++signal)
+    {
+        m_fifo[signal] = std::make_unique<juce::AbstractFifo>(c_fifoFrames * m_fftSize);
+        m_fifoBuffer[signal].assign(c_fifoFrames * m_fftSize, 0.f);
+        m_history[signal].assign(m_fftSize, 0.f);
+        m_power[signal].assign(nrOfBins, 0.f);
+        m_levels[signal].assign(nrOfBins, g_analyzerMinLevel_dB);
+    }
+    m_work.assign(2 * m_fftSize, 0.f);
+}
+
+void SpectrumAnalyzer::prepare(double sampleRate)
+{
+    m_sampleRate = sampleRate;
+}
+
+void SpectrumAnalyzer::setActive(bool isActive)
+{
+    // a new editor starts without the spectra and the samples of the last one (the samples left in
+    // the FIFOs are from the time the last editor was closed; the message thread is the reader)
+    if (isActive && !m_isActive.load())
+        for (auto signal = 0; signal < NrOfSignals; ++signal)
+        {
+            m_fifo[signal]->finishedRead(m_fifo[signal]->getNumReady());
+            std::fill(m_history[signal].begin(), m_history[signal].end(), 0.f);
+            std::fill(m_power[signal].begin(), m_power[signal].end(), 0.f);
+            std::fill(m_levels[signal].begin(), m_levels[signal].end(), g_analyzerMinLevel_dB);
+        }
+    m_isActive = isActive;
+}
+
+template <typename FloatType>
+void SpectrumAnalyzer::pushSamples(Signal signal, const juce::AudioBuffer<FloatType>& buffer)
+{
+    if (!m_isActive.load(std::memory_order_relaxed))
+        return;
+
+    int nrOfChannels = buffer.getNumChannels();
+    if (nrOfChannels == 0)
+        return;
+    int start1, size1, start2, size2;
+    m_fifo[signal]->prepareToWrite(buffer.getNumSamples(), start1, size1, start2, size2);
+    float* data = m_fifoBuffer[signal].data();
+    auto gain = 1.f / nrOfChannels;
+    // both regions of the FIFO, channel by channel
+    for (auto cc = 0; cc < nrOfChannels; ++cc)
+    {
+        const FloatType* channel = buffer.getReadPointer(cc);
+        for (auto kk = 0; kk < size1; ++kk)
+            data[start1 + kk] = (cc == 0 ? 0.f : data[start1 + kk]) + gain * static_cast<float>(channel[kk]);
+        for (auto kk = 0; kk < size2; ++kk)
+            data[start2 + kk] = (cc == 0 ? 0.f : data[start2 + kk]) + gain * static_cast<float>(channel[size1 + kk]);
+    }
+    m_fifo[signal]->finishedWrite(size1 + size2);
+}
+
+bool SpectrumAnalyzer::update()
+{
+    bool hasNewSamples = false;
+    for (auto signal = 0; signal < NrOfSignals; ++signal)
+    {
+        // only the newest fftSize samples are used, older ones are skipped
+        auto& fifo = *m_fifo[signal];
+        int nrOfSamples = fifo.getNumReady();
+        if (nrOfSamples == 0)
+            continue;
+        hasNewSamples = true;
+        int nrOfSkipped = juce::jmax(0, nrOfSamples - m_fftSize);
+        fifo.finishedRead(nrOfSkipped);
+        nrOfSamples -= nrOfSkipped;
+
+        auto& history = m_history[signal];
+        std::memmove(history.data(), history.data() + nrOfSamples, (m_fftSize - nrOfSamples) * sizeof(float));
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(nrOfSamples, start1, size1, start2, size2);
+        const float* data = m_fifoBuffer[signal].data();
+        std::memcpy(history.data() + m_fftSize - nrOfSamples, data + start1, size1 * sizeof(float));
+        std::memcpy(history.data() + m_fftSize - nrOfSamples + size1, data + start2, size2 * sizeof(float));
+        fifo.finishedRead(size1 + size2);
+
+        for (auto kk = 0; kk < m_fftSize; ++kk)
+            m_work[kk] = history[kk] * m_window[kk];
+        m_fft.performFrequencyOnlyForwardTransform(m_work.data());
+
+        auto& power = m_power[signal];
+        auto& levels = m_levels[signal];
+        for (size_t kk = 0; kk < power.size(); ++kk)
+        {
+            power[kk] = g_analyzerAveraging * power[kk] + (1.f - g_analyzerAveraging) * m_work[kk] * m_work[kk];
+            levels[kk] = juce::jmax(g_analyzerMinLevel_dB, 10.f * log10f(power[kk] + 1e-20f));
+        }
+    }
+    return hasNewSamples;
+}
+
+template void SpectrumAnalyzer::pushSamples<float>(Signal signal, const juce::AudioBuffer<float>& buffer);
+template void SpectrumAnalyzer::pushSamples<double>(Signal signal, const juce::AudioBuffer<double>& buffer);
@@ -0,0 +1,85 @@
+/**
+ * @file SpectrumAnalyzer.h
+ * @author J. Bitzer @ Jade HS, BSD Licence
+ * @brief spectrum of the input and output signal of a processor for the GUI
+ * The audio thread pushes the mono sum of both signals into lock free single producer / single consumer
+ * FIFOs (juce::AbstractFifo, no allocation, full FIFOs drop samples), but only while the analyzer is active
+ * (setActive, an open editor), otherwise pushSamples returns after one atomic load.
+ * The message thread calls update (e.g. from a timer with g_guiFrameRate): it reads the FIFOs
+ * and computes one Hann windowed FFT of the newest g_analyzerFFTSize samples per signal,
+ * the power spectra are averaged exponentially (g_analyzerAveraging) and given in dB (0 dB is a full scale sine).
+ * Usage: prepare(sampleRate) in prepareToPlay, pushSamples(Input/Output, buffer) around the processing,
+ * in the GUI setActive(true), update() and getLevels(signal) per frame, setActive(false) if closed
+ * @version 1.1
+ * @date 2026-10-17
+ *
+ * @copyright Copyright (c) 2026
+ *
+ */
+// Version 1.0 AbstractFifo per signal, windowed FFT at the frame rate of the GUI, exponential averaging
+// Version 1.1 setActive(true) drops the samples left in the FIFOs by the last editor
+
+#pragma once
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <JuceHeader.h>
+#include "../PluginSettings.h"
+
+class SpectrumAnalyzer
+{
+public:
+    enum Signal
+    {
+        Input = 0,
+        Output,
+        NrOfSignals
+    };
+
+    SpectrumAnalyzer();
+    /**
+     * @brief sets the sampling rate for the frequency axis (the buffers are allocated in the constructor)
+     *
+     */
+    void prepare(double sampleRate);
+    /**
+     * @brief message thread: pushSamples does nothing while the analyzer is inactive (editor closed)
+     *
+     */
+    void setActive(bool isActive);
+    bool isActive() const {return m_isActive.load(std::memory_order_relaxed);};
+    /**
+     * @brief audio thread: adds the mono sum of all channels to the FIFO of signal (realtime safe)
+     *
+     */
+    template <typename FloatType>
+    void pushSamples(Signal signal, const juce::AudioBuffer<FloatType>& buffer);
+    /**
+     * @brief message thread: reads the FIFOs and computes the new spectra (not realtime safe)
+     *
+     * @return true if new samples were analyzed
+     */
+    bool update();
+    /**
+     * @brief averaged level in dB of the bins 0 ... fftSize/2 of signal (valid after update)
+     *
+     */
+    const std::vector<float>& getLevels(Signal signal) const {return m_levels[signal];};
+    double getSampleRate() const {return m_sampleRate.load();};
+    int getFFTSize() const {return m_fftSize;};
+
+private:
+    int m_fftSize;
+    std::atomic<bool> m_isActive{false};
+    std::atomic<double> m_sampleRate{44100.0};
+    juce::dsp::FFT m_fft;
+    std::vector<float> m_window;
+    // audio thread to message thread
+    std::unique_ptr<juce::AbstractFifo> m_fifo[NrOfSignals];
+    std::vector<float> m_fifoBuffer[NrOfSignals];
+    // message thread: the newest fftSize samples, averaged power and levels
+    std::vector<float> m_history[NrOfSignals];
+    std::vector<float> m_power[NrOfSignals];
+    std::vector<float> m_levels[NrOfSignals];
+    std::vector<float> m_work;
+};
@@ -6,39 +6,88 @@
 
 #include "SynchronBlockProcessor.h"
 
-SynchronBlockProcessor::SynchronBlockProcessor()
-:m_NrOfChannels(2),m_OutBlockSize(256)
+template <typename FloatType>
+SynchronBlockProcessor<FloatType>::SynchronBlockProcessor()
+:m_NrOfChannels(2),m_OutBlockSize(256),m_OutCounter(0),m_InCounter(0),m_pastSamples(0)
 {
     prepareSynchronProcessing(m_NrOfChannels,m_OutBlockSize);
+    applyNewConfiguration();
 }
-void SynchronBlockProcessor::prepareSynchronProcessing(int channels, int desiredSize)
+template <typename FloatType>
+SynchronBlockProcessor<FloatType>::~SynchronBlockProcessor()
 {
-    ScopedLock lock(m_protectBlock);
-    //m_protectBlock.enter();
-    m_OutBlockSize = desiredSize;
-    m_NrOfChannels = channels;
-    m_memory.setSize(m_NrOfChannels,2*m_OutBlockSize);
-    m_memory.clear();
-    m_block.setSize(m_NrOfChannels,m_OutBlockSize);
-    m_block.clear();
+    delete m_newConfiguration.exchange(nullptr);
+    freeRetiredConfigurations();
+}
+template <typename FloatType>
+void SynchronBlockProcessor<FloatType>::prepareSynchronProcessing(int channels, int desiredSize, bool zeroLatency)
+{
+    ScopedLock lock(m_protectPrepare);
+    freeRetiredConfigurations();
+
+    auto configuration = new Configuration;
+    configuration->outBlockSize = desiredSize;
+    configuration->nrOfChannels = channels;
+    configuration->memory.setSize(channels,2*jmax(desiredSize,1));
+    configuration->memory.clear();
+    configuration->block.setSize(channels,jmax(desiredSize,1));
+    configuration->block.clear();
+    configuration->mididata.ensureSize(c_midiBufferBytes);
+    configuration->directthrue = desiredSize < 1;
+    configuration->zeroLatency = zeroLatency;
+    m_delay = (configuration->directthrue || zeroLatency) ? 0 : desiredSize;
+
+    // a configuration that has not been used yet is replaced
+    delete m_newConfiguration.exchange(configuration);
+}
+template <typename FloatType>
+void SynchronBlockProcessor<FloatType>::applyNewConfiguration()
+{
+    auto configuration = m_newConfiguration.exchange(nullptr);
+    if (configuration == nullptr)
+        return;
+
+    // swap, no allocation: the configuration keeps the old buffers until it is freed in prepare
+    m_OutBlockSize = configuration->outBlockSize;
+    m_NrOfChannels = configuration->nrOfChannels;
+    m_directthrue = configuration->directthrue;
+    m_zeroLatency = configuration->zeroLatency;
+    std::swap(m_memory, configuration->memory);
+    std::swap(m_block, configuration->block);
+    std::swap(m_mididata, configuration->mididata);
     m_OutCounter = 0;
     m_InCounter = 0;
-    m_mididata.clear();
     m_pastSamples = 0;
-    if (desiredSize < 1)
-        m_directthrue = true;
-    else
-        m_directthrue = false;
-    //m_protectBlock.exit();
+
+    configuration->nextRetired = m_retiredConfigurations.load();
+    while (!m_retiredConfigurations.compare_exchange_weak(configuration->nextRetired, configuration))
+        ;
 }
-void SynchronBlockProcessor::processBlock(juce::AudioBuffer<float>& data, juce::MidiBuffer& midiMessages)
+template <typename FloatType>
+void SynchronBlockProcessor<FloatType>::freeRetiredConfigurations()
 {
-    ScopedLock lock(m_protectBlock);
+    auto configuration = m_retiredConfigurations.exchange(nullptr);
+    while (configuration != nullptr)
+    {
+        auto next = configuration->nextRetired;
+        delete configuration;
+        configuration = next;
+    }
+}
+template <typename FloatType>
+void SynchronBlockProcessor<FloatType>::processBlock(juce::AudioBuffer<FloatType>& data, juce::MidiBuffer& midiMessages)
+{
+    applyNewConfiguration();
     if (m_directthrue == true)
     {
         processSynchronBlock(data, midiMessages);
+        return;
+    }
+    if (m_zeroLatency == true)
+    {
+        processSlices(data, midiMessages);
+        return;
     }
-    // m_protectBlock.enter();
     int nrofBlockProcessed = 0;
     auto readdatapointers = data.getArrayOfReadPointers();
     auto writedatapointers = data.getArrayOfWritePointers();
@@ -112,15 +161,49 @@ void SynchronBlockProcessor::processBlock(juce::AudioBuffer<float>& data, juce::
         m_mididata.addEvents(midiMessages,0,nrOfInputSamples,m_pastSamples);
         m_pastSamples += nrOfInputSamples;
     }
-    //m_protectBlock.exit();
 }
 
-int SynchronBlockProcessor::getDelay()
+template <typename FloatType>
+void SynchronBlockProcessor<FloatType>::processSlices(juce::AudioBuffer<FloatType>& data, juce::MidiBuffer& midiMessages)
 {
-    if (m_directthrue)
-        return 0;
-    else
-        return m_OutBlockSize;
+    int nrOfInputSamples = data.getNumSamples();
+    int nrOfChannels = data.getNumChannels();
+    int startSample = 0;
+    while (startSample < nrOfInputSamples)
+    {
+        // m_InCounter is the position within the current block, the slice ends on the block boundary
+        int sliceSize = jmin(m_OutBlockSize - m_InCounter, nrOfInputSamples - startSample);
+        m_mididata.addEvents(midiMessages, startSample, sliceSize, -startSample);
+        if (nrOfChannels <= c_maxReferencedChannels)
+        {
+            // refers to the host data (no copy, no allocation)
+            juce::AudioBuffer<FloatType> slice(data.getArrayOfWritePointers(), nrOfChannels, startSample, sliceSize);
+            processSynchronBlock(slice, m_mididata);
+        }
+        else
+        {
+            // a buffer referring to more channels allocates its channel list, m_block is used instead
+            // (its memory is large enough, setSize does not allocate)
+            m_block.setSize(nrOfChannels, sliceSize, false, false, true);
+            for (auto cc = 0; cc < nrOfChannels; ++cc)
+                m_block.copyFrom(cc, 0, data, cc, startSample, sliceSize);
+            processSynchronBlock(m_block, m_mididata);
+            for (auto cc = 0; cc < nrOfChannels; ++cc)
+                data.copyFrom(cc, startSample, m_block, cc, 0, sliceSize);
+        }
+        m_mididata.clear();
+
+        startSample += sliceSize;
+        m_InCounter += sliceSize;
+        if (m_InCounter == m_OutBlockSize)
+            m_InCounter = 0;
+    }
+}
+
+template <typename FloatType>
+int SynchronBlockProcessor<FloatType>::getDelay()
+{
+    return m_delay;
 }
 /* // Midi Debugcode
     auto a = midiMessages.getNumEvents();
@@ -144,141 +227,99 @@ int SynchronBlockProcessor::getDelay()
             }
 //*/
 
-WOLA::WOLA()
-:m_FullBlockSize(1024),m_NrOfChannels(2),m_InCounter(0),m_OutCounter(0),m_nrOfBlocks(3),m_wolaType(WOLAType::SqrtHann_over75)
+template <typename FloatType>
+WOLA<FloatType>::WOLA()
+:m_FullBlockSize(1024),m_NrOfChannels(2),m_hopSize(512),m_framePosition(0)
 {
     prepareWOLAprocessing(m_NrOfChannels,m_FullBlockSize);
 }
 
-WOLA::~WOLA()
+template <typename FloatType>
+WOLA<FloatType>::~WOLA()
 {
 }
 
-int WOLA::prepareWOLAprocessing(int channels, int desiredSize, WOLAType wolalaptype)
+template <typename FloatType>
+int WOLA<FloatType>::prepareWOLAprocessing(int channels, int desiredSize, WOLAType wolalaptype)
 {
-    m_NrOfChannels = channels;
-    m_FullBlockSize = desiredSize;
-    m_wolaType = wolalaptype;
-
-    m_analWin.setSize(1,m_FullBlockSize);
-    m_analWin.clear();
-    m_synWin.setSize(1,m_FullBlockSize);
-    m_synWin.clear();
-    m_audioBlock.setSize(m_NrOfChannels,m_FullBlockSize);
-    m_audioBlock.clear();
-    m_mem50aOut.setSize(m_NrOfChannels,m_FullBlockSize/2);
-    m_mem50aOut.clear();
-    m_mem50bOut.setSize(m_NrOfChannels,m_FullBlockSize/2);
-    m_mem50bOut.clear();
-    m_mem50aIn.setSize(m_NrOfChannels,m_FullBlockSize/2);
-    m_mem50aIn.clear();
-    m_mem50bIn.setSize(m_NrOfChannels,m_FullBlockSize/2);
-    m_mem50bIn.clear();
-    // 75% Overlap
-    m_mem25aIn.setSize(m_NrOfChannels,m_FullBlockSize/4);
-    m_mem25aIn.clear();
-    m_mem25bIn.setSize(m_NrOfChannels,m_FullBlockSize/4);
-    m_mem25bIn.clear();
-    m_mem25cIn.setSize(m_NrOfChannels,m_FullBlockSize/4);
-    m_mem25cIn.clear();
-    m_mem25dIn.setSize(m_NrOfChannels,m_FullBlockSize/4);
-    m_mem25dIn.clear();
-    m_mem25aOut.setSize(m_NrOfChannels,3*m_FullBlockSize/4);
-    m_mem25aOut.clear();
-    m_mem25bOut.setSize(m_NrOfChannels,3*m_FullBlockSize/4);
-    m_mem25bOut.clear();
-    m_mem25cOut.setSize(m_NrOfChannels,3*m_FullBlockSize/4);
-    m_mem25cOut.clear();
-    m_mem25dOut.setSize(m_NrOfChannels,3*m_FullBlockSize/4);
-    m_mem25dOut.clear();
-    
-    m_OutCounter = 0;
-    m_InCounter = 0;
-
-    switch (m_wolaType)
+    switch (wolalaptype)
     {
     case WOLAType::NoWin_over75:
-        getWindow(m_analWin, WinType::Rect);
-        getWindow(m_synWin, WinType::Rect);
-        prepareSynchronProcessing(m_NrOfChannels,m_FullBlockSize/4);
-        break;
+        return prepareWOLAprocessing(channels, desiredSize, 4, WinType::Rect, WinType::Rect);
     case WOLAType::NoWin_over50:
-        getWindow(m_analWin, WinType::Rect);
-        getWindow(m_synWin, WinType::Rect);
-        prepareSynchronProcessing(m_NrOfChannels,m_FullBlockSize/2);
-        break;
+        return prepareWOLAprocessing(channels, desiredSize, 2, WinType::Rect, WinType::Rect);
     case WOLAType::HannRect_over75: 
-        getWindow(m_analWin, WinType::Hann);
-        getWindow(m_synWin, WinType::Rect);
-        prepareSynchronProcessing(m_NrOfChannels,m_FullBlockSize/4);
-        break;
+        return prepareWOLAprocessing(channels, desiredSize, 4, WinType::Hann, WinType::Rect);
     case WOLAType::HannRect_over50:
-        getWindow(m_analWin, WinType::Hann);
-        getWindow(m_synWin, WinType::Rect);
-        prepareSynchronProcessing(m_NrOfChannels,m_FullBlockSize/2);
-        break;
+        return prepareWOLAprocessing(channels, desiredSize, 2, WinType::Hann, WinType::Rect);
     case WOLAType::RectHann_over75: 
-        getWindow(m_synWin, WinType::Hann);
-        getWindow(m_analWin, WinType::Rect);
-        prepareSynchronProcessing(m_NrOfChannels,m_FullBlockSize/4);
-        break;
+        return prepareWOLAprocessing(channels, desiredSize, 4, WinType::Rect, WinType::Hann);
     case WOLAType::RectHann_over50:
-        getWindow(m_synWin, WinType::Hann);
-        getWindow(m_analWin, WinType::Rect);
-        prepareSynchronProcessing(m_NrOfChannels,m_FullBlockSize/2);
-        break;
+        return prepareWOLAprocessing(channels, desiredSize, 2, WinType::Rect, WinType::Hann);
     case WOLAType::SqrtHann_over75:
-        getWindow(m_analWin, WinType::SqrtHann);
-        getWindow(m_synWin, WinType::SqrtHann);
-        prepareSynchronProcessing(m_NrOfChannels,m_FullBlockSize/4);
-        break;
+        return prepareWOLAprocessing(channels, desiredSize, 4, WinType::SqrtHann, WinType::SqrtHann);
     case WOLAType::SqrtHann_over50:
-        getWindow(m_analWin, WinType::SqrtHann);
-        getWindow(m_synWin, WinType::SqrtHann);
-        prepareSynchronProcessing(m_NrOfChannels,m_FullBlockSize/2);
-
-        break;
+        return prepareWOLAprocessing(channels, desiredSize, 2, WinType::SqrtHann, WinType::SqrtHann);
     default:
         break;
     }
+    return -1;
+}
+
+template <typename FloatType>
+int WOLA<FloatType>::prepareWOLAprocessing(int channels, int desiredSize, int nrOfOverlaps, WinType analysisWindow, WinType synthesisWindow)
+{
+    jassert(nrOfOverlaps >= 1 && desiredSize % nrOfOverlaps == 0);
+    m_NrOfChannels = channels;
+    m_FullBlockSize = desiredSize;
+    m_hopSize = desiredSize / nrOfOverlaps;
+    m_framePosition = 0;
 
+    m_analWin.setSize(1,m_FullBlockSize);
+    m_synWin.setSize(1,m_FullBlockSize);
+    getWindow(m_analWin, analysisWindow);
+    getWindow(m_synWin, synthesisWindow);
+    // the frames add up to sum(analysis * synthesis)/hop (constant for the periodic windows)
+    auto analptr = m_analWin.getReadPointer(0);
+    auto synptr = m_synWin.getReadPointer(0);
+    double windowSum = 0.0;
+    for (auto kk = 0; kk < m_FullBlockSize; ++kk)
+        windowSum += static_cast<double>(analptr[kk]) * synptr[kk];
+    m_synWin.applyGain(static_cast<FloatType>(m_hopSize / windowSum));
+
+    m_audioBlock.setSize(m_NrOfChannels,m_FullBlockSize);
+    m_audioBlock.clear();
+    m_inputHistory.setSize(m_NrOfChannels,m_FullBlockSize);
+    m_inputHistory.clear();
+    m_outputSum.setSize(m_NrOfChannels,m_FullBlockSize);
+    m_outputSum.clear();
 
+    this->prepareSynchronProcessing(m_NrOfChannels,m_hopSize);
     return 0;
 }
 
-int WOLA::processSynchronBlock(juce::AudioBuffer<float> &inBlock, juce::MidiBuffer &midiMessages)
+template <typename FloatType>
+int WOLA<FloatType>::processSynchronBlock(juce::AudioBuffer<FloatType> &inBlock, juce::MidiBuffer &midiMessages)
 {
-    //m_protectBlock.enter();
     int nrOfChannels = inBlock.getNumChannels();
-    
+    // the new hop replaces the oldest one, the frame starts after it
+    int hopPosition = m_framePosition;
+    m_framePosition += m_hopSize;
+    if (m_framePosition == m_FullBlockSize)
+        m_framePosition = 0;
+    // the ring buffers wrap once within a frame
+    int firstPart = m_FullBlockSize - m_framePosition;
+    int secondPart = m_framePosition;
+
+    auto winptr = m_analWin.getReadPointer(0);
     for (auto kk = 0; kk < nrOfChannels; ++kk)
     {
-        if ((m_wolaType == WOLAType::NoWin_over50) | (m_wolaType == WOLAType::SqrtHann_over50) | (m_wolaType == WOLAType::HannRect_over50) | (m_wolaType == WOLAType::RectHann_over50))
-        {
-            m_audioBlock.copyFrom(kk,m_FullBlockSize/2,inBlock,kk,0,m_FullBlockSize/2);
-            m_audioBlock.copyFrom(kk,0,m_mem50aIn,kk,0,m_FullBlockSize/2);
-            m_mem50aIn.copyFrom(kk,0,inBlock,kk,0,m_FullBlockSize/2);
-
-        }
-        else if ((m_wolaType == WOLAType::NoWin_over75) | (m_wolaType == WOLAType::SqrtHann_over75) | (m_wolaType == WOLAType::HannRect_over75)| (m_wolaType == WOLAType::RectHann_over75))
-        {
-            m_audioBlock.copyFrom(kk,3*m_FullBlockSize/4,inBlock,kk,0,m_FullBlockSize/4);
-            m_audioBlock.copyFrom(kk,2*m_FullBlockSize/4,m_mem25aIn, kk,0,m_FullBlockSize/4);
-            m_audioBlock.copyFrom(kk,1*m_FullBlockSize/4,m_mem25bIn, kk,0,m_FullBlockSize/4);
-            m_audioBlock.copyFrom(kk,0*m_FullBlockSize/4,m_mem25cIn, kk,0,m_FullBlockSize/4);
-            // This can be solved in a better way by changing pointers
-            m_mem25cIn.copyFrom(kk,0,m_mem25bIn,kk,0,m_FullBlockSize/4);
-            m_mem25bIn.copyFrom(kk,0,m_mem25aIn,kk,0,m_FullBlockSize/4);
-            m_mem25aIn.copyFrom(kk,0,inBlock,kk,0,m_FullBlockSize/4);
-
-        }
-        // apply window
-        auto winptr = m_analWin.getReadPointer(0);
+        auto historyptr = m_inputHistory.getWritePointer(kk);
         auto audioptr = m_audioBlock.getWritePointer(kk);
-        for (auto ss = 0; ss < m_FullBlockSize; ++ss)
-        {
-            audioptr[ss] *= winptr[ss];
-        }
+        FloatVectorOperations::copy(historyptr + hopPosition, inBlock.getReadPointer(kk), m_hopSize);
+        // apply window
+        FloatVectorOperations::multiply(audioptr, historyptr + m_framePosition, winptr, firstPart);
+        FloatVectorOperations::multiply(audioptr + firstPart, historyptr, winptr + firstPart, secondPart);
     }
     // processing
 
@@ -300,90 +341,29 @@ int WOLA::processSynchronBlock(juce::AudioBuffer<float> &inBlock, juce::MidiBuff
     processWOLA(m_audioBlock,midiMessages);
 
     // defines outputs
+    winptr = m_synWin.getReadPointer(0);
     for (auto kk = 0; kk < nrOfChannels; ++kk)
     {
-        // apply sythesis window
-        auto winptr = m_synWin.getReadPointer(0);
-        auto audioptr = m_audioBlock.getWritePointer(kk);
-        for (auto ss = 0; ss < m_FullBlockSize; ++ss)
-        {
-            audioptr[ss] *= winptr[ss];
-        }
-
-        if ((m_wolaType == WOLAType::NoWin_over50) | (m_wolaType == WOLAType::SqrtHann_over50) | (m_wolaType == WOLAType::HannRect_over50) | (m_wolaType == WOLAType::RectHann_over50))
-        {
-            inBlock.copyFrom(kk,0,m_audioBlock,kk,0,m_FullBlockSize/2);
-            inBlock.addFrom(kk,0,m_mem50aOut,kk,0,m_FullBlockSize/2);
-            m_mem50aOut.copyFrom(kk,0,m_audioBlock,kk,m_FullBlockSize/2,m_FullBlockSize/2);
-        }
-        else if ((m_wolaType == WOLAType::NoWin_over75) | (m_wolaType == WOLAType::SqrtHann_over75) | (m_wolaType == WOLAType::HannRect_over75) | (m_wolaType == WOLAType::RectHann_over75))
-        {
-            inBlock.copyFrom(kk,0,m_audioBlock,kk,0,m_FullBlockSize/4);
-            int whichPartCounter = (m_OutCounter+2)%m_nrOfBlocks;
-            inBlock.addFrom(kk,0,m_mem25aOut,kk,whichPartCounter*m_FullBlockSize/4,m_FullBlockSize/4);
-            whichPartCounter = (m_OutCounter+1)%m_nrOfBlocks;
-            inBlock.addFrom(kk,0,m_mem25bOut,kk,whichPartCounter*m_FullBlockSize/4,m_FullBlockSize/4);
-            whichPartCounter = (m_OutCounter)%m_nrOfBlocks;
-            inBlock.addFrom(kk,0,m_mem25cOut,kk,whichPartCounter*m_FullBlockSize/4,m_FullBlockSize/4);
-
-            if (m_OutCounter == 0)
-            {
-                m_mem25aOut.copyFrom(kk,0,m_audioBlock,kk,m_FullBlockSize/4,3*m_FullBlockSize/4);
-            }
-            else if (m_OutCounter == 1)
-            {
-                m_mem25bOut.copyFrom(kk,0,m_audioBlock,kk,m_FullBlockSize/4,3*m_FullBlockSize/4);
-            }
-            else if (m_OutCounter == 2)
-            {
-                m_mem25cOut.copyFrom(kk,0,m_audioBlock,kk,m_FullBlockSize/4,3*m_FullBlockSize/4);
-            }
-            
-        }
+        // apply sythesis window and overlap-add
+        auto sumptr = m_outputSum.getWritePointer(kk);
+        auto audioptr = m_audioBlock.getReadPointer(kk);
+        FloatVectorOperations::addWithMultiply(sumptr + m_framePosition, audioptr, winptr, firstPart);
+        FloatVectorOperations::addWithMultiply(sumptr, audioptr + firstPart, winptr + firstPart, secondPart);
+        // the first hop of the frame is complete (no later frame covers it)
+        FloatVectorOperations::copy(inBlock.getWritePointer(kk), sumptr + m_framePosition, m_hopSize);
+        FloatVectorOperations::clear(sumptr + m_framePosition, m_hopSize);
     }
-    m_OutCounter++;
-    if (m_OutCounter == m_nrOfBlocks)
-    {
-        m_OutCounter = 0;
-    }
-
-    switch (m_wolaType)
-    {
-    case WOLAType::NoWin_over75:
-        inBlock.applyGain(0.25f);
-        break;
-    case WOLAType::NoWin_over50:
-        inBlock.applyGain(0.5f);
-        break;
-    case WOLAType::HannRect_over75: 
-        inBlock.applyGain(0.5f);
-        break;
-    case WOLAType::HannRect_over50:
-        break;
-    case WOLAType::RectHann_over75: 
-        inBlock.applyGain(0.5f);
-        break;
-    case WOLAType::RectHann_over50:
-        break;
-    case WOLAType::SqrtHann_over75:
-        inBlock.applyGain(0.5f);
-        break;
-    case WOLAType::SqrtHann_over50:
-
-        break;
-    default:
-        break;
-    }
-
     return 0;
 }
 
-int WOLA::getDelay()
+template <typename FloatType>
+int WOLA<FloatType>::getDelay()
 {
     return m_FullBlockSize;
 }
 
-int WOLA::getWindow(juce::AudioBuffer<float> &win, WinType wintype)
+template <typename FloatType>
+int WOLA<FloatType>::getWindow(juce::AudioBuffer<FloatType> &win, WinType wintype)
 {
     int len = win.getNumSamples();
     auto winptr = win.getWritePointer(0);
@@ -391,23 +371,40 @@ int WOLA::getWindow(juce::AudioBuffer<float> &win, WinType wintype)
     {
         for (auto kk = 0; kk < len; ++kk)
         {
-            winptr[kk] = sqrtf(0.5f*(1.f - static_cast<float>(cos(2.f*kk*M_PI / (len - 1)))));
+            winptr[kk] = static_cast<FloatType>(sqrt(0.5*(1.0 - cos(2.0*kk*M_PI / len))));
         }
     }
     else if (wintype == WinType::Hann)
     {
         for (auto kk = 0; kk < len; ++kk)
         {
-            winptr[kk] = 0.5f*(1.f - static_cast<float>(cos(2.f*kk*M_PI / (len - 1))));
+            winptr[kk] = static_cast<FloatType>(0.5*(1.0 - cos(2.0*kk*M_PI / len)));
+        }
+    }
+    else if (wintype == WinType::ZeroPaddedHann)
+    {
+        int quarter = len / 4;
+        int half = len - 2*quarter;
+        for (auto kk = 0; kk < len; ++kk)
+        {
+            if (kk < quarter || kk >= quarter + half)
+                winptr[kk] = FloatType(0);
+            else
+                winptr[kk] = static_cast<FloatType>(0.5*(1.0 - cos(2.0*(kk - quarter)*M_PI / half)));
         }
     }
     else if (wintype == WinType::Rect)
     {
         for (auto kk = 0; kk < len; ++kk)
         {
-            winptr[kk] = 1.f;
+            winptr[kk] = FloatType(1);
         }
     }
 
     return 0;
 }
+
+template class SynchronBlockProcessor<float>;
+template class SynchronBlockProcessor<double>;
+template class WOLA<float>;
+template class WOLA<double>;
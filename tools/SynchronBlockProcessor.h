@@ -14,68 +14,109 @@
 // class to rebuffer an JUCE AudioBuffer and MidiMessageQueue of arbitrary length to AudioBuffer of a given length
 // Useful for fft processing or faster parameter updates and modulation
 // if desiredSize is < 1 (zero or negative) , the processing will be done directly without buffering
+// in zero latency mode the host buffer is processed in place in slices ending on the block boundaries
+// (slices can be shorter than desiredSize, no delay)
 // Usage: Inherit from this class and override ProcessSynchronBlock
 // (c) J. Bitzer @ Jade HS, BSD Licence
 //
 // Version 2.0 (only JUCE AUdioBUffer, without std::vector)
 // Version 2.1 (added directthrue option and changed CriticalSection to ScopedLock (RAII))
-
-/* ToDO:
-1) rewrite as template class for double
-//*/
+// Version 2.2 (template class for float and double)
+// Version 2.3 (zero latency mode with in place slices, directthrue does not fall through into the buffered path)
+// Version 2.4 (lock free reconfiguration: prepareSynchronProcessing publishes new buffers atomically,
+//              processBlock swaps them in without a lock, the old ones are freed by the next prepare call)
+// Version 2.5 (zero latency slices of more than 31 channels are copied, a referring buffer would allocate)
+// Version 2.6 (WOLA with any overlap: ring buffers for the input history and the overlap-add instead of
+//              shifted frame copies, windowing with FloatVectorOperations)
+// Version 2.7 (ZeroPaddedHann window: Hann over the middle half of the frame, zeros in the outer quarters)
 
 #pragma once
+#include <atomic>
 #include <JuceHeader.h>
 
+template <typename FloatType>
 class SynchronBlockProcessor
 {
 public:
+    // memory reserved for the midi events of one synchron block, addEvents does not allocate below this size
+    static constexpr int c_midiBufferBytes = 8192;
+    // a juce::AudioBuffer referring to external data allocates its channel list above this number of channels
+    static constexpr int c_maxReferencedChannels = 31;
+
     SynchronBlockProcessor();
-    ~SynchronBlockProcessor(){};
+    ~SynchronBlockProcessor();
     /**
      * @brief preparetoprocess sets the desired blocksize for a given numer of channels
-     * it can be called at any time (threadsafe), but it will cause audio-glitches (not realtime safe)
+     * it can be called at any time (threadsafe, but not from the audio thread), the new buffers are allocated
+     * here and used from the next processBlock call on (the audio thread never waits for a lock)
      * 
      * @param channels 
      * @param desiredSize 
+     * @param zeroLatency if true, processSynchronBlock is called in place with slices of the host buffer
+     * of at most desiredSize samples (the block boundaries are kept across host buffers), no delay
      */
-    void prepareSynchronProcessing(int channels, int desiredSize); 
+    void prepareSynchronProcessing(int channels, int desiredSize, bool zeroLatency = false); 
     /**
      * @brief the typical JUCE call just forward the call in Processor
      * 
      * @param data 
      * @param midiMessages 
      */
-    void processBlock(juce::AudioBuffer<float>& data, juce::MidiBuffer& midiMessages);
+    void processBlock(juce::AudioBuffer<FloatType>& data, juce::MidiBuffer& midiMessages);
     /**
      * @brief processSynchronBlock is your new processing routine. The block will always be of size desiredSize
+     * (in zero latency mode it can be shorter)
      * 
      * @param midiMessages 
      * @return int 
      */
-    virtual int processSynchronBlock(juce::AudioBuffer<float>&, juce::MidiBuffer& midiMessages) = 0;
+    virtual int processSynchronBlock(juce::AudioBuffer<FloatType>&, juce::MidiBuffer& midiMessages) = 0;
     /**
      * @brief Get the Delay object
      * 
-     * @return int this will be DesiredSize
+     * @return int this will be DesiredSize (0 in zero latency and directthrue mode)
      */
     int getDelay();
 private:
-    CriticalSection m_protectBlock;
+    // new buffers and settings, built by prepareSynchronProcessing and swapped in by the audio thread
+    struct Configuration
+    {
+        int nrOfChannels;
+        int outBlockSize;
+        bool directthrue;
+        bool zeroLatency;
+        juce::AudioBuffer<FloatType> memory;
+        juce::AudioBuffer<FloatType> block;
+        MidiBuffer mididata;
+        Configuration* nextRetired = nullptr;
+    };
+    void applyNewConfiguration(); // audio thread
+    void freeRetiredConfigurations(); // not on the audio thread
+    void processSlices(juce::AudioBuffer<FloatType>& data, juce::MidiBuffer& midiMessages);
+
+    CriticalSection m_protectPrepare; // serializes prepare calls, never taken by the audio thread
+    std::atomic<Configuration*> m_newConfiguration{nullptr};
+    // lock free stack of replaced configurations (pushed by the audio thread, freed in prepare)
+    std::atomic<Configuration*> m_retiredConfigurations{nullptr};
+    std::atomic<int> m_delay{0};
+
+    // used by the audio thread only
     int m_NrOfChannels;
     int m_OutBlockSize;
     int m_OutCounter;
     int m_InCounter;
 
-    juce::AudioBuffer<float> m_memory;
-    juce::AudioBuffer<float> m_block;
+    juce::AudioBuffer<FloatType> m_memory;
+    juce::AudioBuffer<FloatType> m_block;
 
     MidiBuffer m_mididata;
     int m_pastSamples;
     bool m_directthrue = false;
+    bool m_zeroLatency = false;
 };
 
-class WOLA : public SynchronBlockProcessor
+template <typename FloatType>
+class WOLA : public SynchronBlockProcessor<FloatType>
 {
 public: 
     enum class WOLAType
@@ -94,44 +135,48 @@ public:
         Rect,
         Hann,
         SqrtHann,
+        // Hann of half the frame length in the middle of the frame, zeros in the outer quarters:
+        // the frames can be filtered by circular convolution with kernels up to half the frame length
+        // without time aliasing (use with Rect synthesis)
+        ZeroPaddedHann,
     };
 
     WOLA();
     ~WOLA();
+    /**
+     * @brief prepares one of the predefined window and overlap combinations (see prepareWOLAprocessing below)
+     *
+     */
     int prepareWOLAprocessing(int channels, int desiredSize, WOLAType wolalaptype = WOLAType::NoWin_over50); 
-    int processSynchronBlock(juce::AudioBuffer<float>&, juce::MidiBuffer& midiMessages);    
-    virtual int processWOLA(juce::AudioBuffer<float>&, juce::MidiBuffer& midiMessages) = 0;
+    /**
+     * @brief prepares the processing of frames with desiredSize samples and a hop size of desiredSize/nrOfOverlaps
+     * (e.g. 2 for 50%, 4 for 75%, 8 for 87.5% overlap), the overlap-add is normalized to a unity gain
+     *
+     * @param channels
+     * @param desiredSize frame length, a multiple of nrOfOverlaps
+     * @param nrOfOverlaps number of frames covering each sample
+     * @param analysisWindow
+     * @param synthesisWindow
+     */
+    int prepareWOLAprocessing(int channels, int desiredSize, int nrOfOverlaps, WinType analysisWindow, WinType synthesisWindow);
+    int processSynchronBlock(juce::AudioBuffer<FloatType>&, juce::MidiBuffer& midiMessages);    
+    virtual int processWOLA(juce::AudioBuffer<FloatType>&, juce::MidiBuffer& midiMessages) = 0;
     int getDelay();
-    int getWindow(juce::AudioBuffer<float>&, WinType wintype = WinType::Hann);
+    int getHopSize() const {return m_hopSize;};
+    int getWindow(juce::AudioBuffer<FloatType>&, WinType wintype = WinType::Hann);
     
 private:
     int m_FullBlockSize;
     int m_NrOfChannels;
-    int m_InCounter;
-    int m_OutCounter;
-    int m_nrOfBlocks;
-    WOLAType m_wolaType;
-
-    juce::AudioBuffer<float> m_audioBlock;
-    juce::AudioBuffer<float> m_analWin;
-    juce::AudioBuffer<float> m_synWin;
-    
-    // memory blocks for 50% overlap
-    juce::AudioBuffer<float> m_mem50aOut;
-    juce::AudioBuffer<float> m_mem50bOut;
-    juce::AudioBuffer<float> m_mem50aIn;
-    juce::AudioBuffer<float> m_mem50bIn;
-
-    // memory blocks for 75% overlap
-    juce::AudioBuffer<float> m_mem25aIn;
-    juce::AudioBuffer<float> m_mem25bIn;
-    juce::AudioBuffer<float> m_mem25cIn;
-    juce::AudioBuffer<float> m_mem25dIn;
-
-    juce::AudioBuffer<float> m_mem25aOut;
-    juce::AudioBuffer<float> m_mem25bOut;
-    juce::AudioBuffer<float> m_mem25cOut;
-    juce::AudioBuffer<float> m_mem25dOut;
+    int m_hopSize;
+    // start of the current frame in the ring buffers (a multiple of the hop size)
+    int m_framePosition;
 
+    juce::AudioBuffer<FloatType> m_audioBlock;
+    juce::AudioBuffer<FloatType> m_analWin;
+    juce::AudioBuffer<FloatType> m_synWin; // includes the normalization of the overlap-add
 
+    // ring buffers of one frame length: the last desiredSize input samples and the overlap-add sums
+    juce::AudioBuffer<FloatType> m_inputHistory;
+    juce::AudioBuffer<FloatType> m_outputSum;
 };
\ No newline at end of file